@@ -0,0 +1,381 @@
+#ifndef ADAPTIVE_HEAP_HPP
+#define ADAPTIVE_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <memory>     // allocator
+#include <algorithm>  // upper_bound, move_backward, sort
+#include <functional> // less
+#include <utility>    // move
+#include <stdexcept>
+#include <limits>
+#include "heap_algorithm.hpp"
+
+
+/*!
+ * \brief The adaptive_heap class implements a maximum priority queue which
+ * switches its representation with its size, with the same interface as
+ * binary_heap.
+ * Up to N elements, the elements are kept in an inline array sorted in
+ * ascending order : the top is the last element, extracting it costs O(1) and
+ * an insertion shifts at most N elements, which beats a heap for small sizes.
+ * When an insertion finds the array full, the elements are moved to an
+ * Arity-ary heap in allocated storage, in O(N) since the array in descending
+ * order is already a heap. When the size goes back down to N/2, the elements
+ * are moved back to the array and sorted. The gap between the two thresholds
+ * keeps a queue whose size oscillates around N from switching at each
+ * operation, and the allocated storage is kept when switching back, such that
+ * it is allocated again only if the heap grows larger than ever.
+ * The indices used by remove() and change_priority() are positions in the
+ * current representation, as returned by find().
+ */
+template<class T, size_t N = 16, size_t Arity = 4, class Allocator = std::allocator<T>>
+class adaptive_heap
+{
+    static_assert(N >= 2, "adaptive_heap inline capacity must be at least 2") ;
+
+    public:
+        /*!
+         * \brief Constructs an empty heap with a given
+         * maximum size.
+         * \param sizeMax the maximum size of the heap, unbounded
+         * by default.
+         * \param allocator the allocator used when the heap outgrows
+         * its inline storage.
+         */
+        adaptive_heap(size_t sizeMax = std::numeric_limits<size_t>::max(),
+                      const Allocator& allocator = Allocator()) ;
+        /*!
+         * \brief Constructs a heap from a given vector. The maximum
+         * size is set to the vector size.
+         * \param v a vector to construct the heap from.
+         * \param allocator the allocator used when the vector does not
+         * fit in the inline storage.
+         */
+        adaptive_heap(const std::vector<T>& v, const Allocator& allocator = Allocator()) ;
+
+        // methods
+        /*!
+         * \brief Returns the maximum value of the heap.
+         * \return the maximum value.
+         */
+        T top() const ;
+        /*!
+         * \brief Removes and return the maximum value of the
+         * heap.
+         * \return the maximum value.
+         */
+        T extract_top() ;
+
+        /*!
+         * \brief Insert a given value within the heap.
+         * \param value a value to insert.
+         * \throw std::runtime_error if the heap is full.
+         */
+        void insert(T value) ;
+        /*!
+         * \brief Removes the value at the given index.
+         * \param index the index of the value to remove.
+         */
+        void remove(int index) ;
+        /*!
+         * \brief Changes the priority of the value located
+         * at the given index with the given value.
+         * \param index the index of the priority value to change.
+         * \param priority the new priority value.
+         */
+        void change_priority(int index, T priority) ;
+
+        /*!
+         * \brief Searches the heap for the given value and returns
+         * its index. If it could not be found, -1 is returned. This
+         * method is not time efficient (O(n)).
+         * \param value a value to find in the heap.
+         * \return the index of the value if it has been found,
+         * -1 otherwise.
+         */
+        int find(T value) const ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+        /*!
+         * \brief Checks whether the elements are stored in the
+         * sorted inline array (otherwise in the d-ary heap).
+         * \return whether the elements are in the sorted array.
+         */
+        bool sorted() const ;
+        /*!
+         * \brief Returns the number of switches between the two
+         * representations.
+         * \return the number of switches.
+         */
+        size_t switches() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * an adaptive heap to a stream.
+         * \param stream an output stream of interest.
+         * \param h an adaptive heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U, size_t M, size_t D, class A>
+        friend std::ostream& operator << (std::ostream& stream, const adaptive_heap<U,M,D,A>& h) ;
+
+    private:
+        typedef std::ptrdiff_t index_type ;
+        typedef std::less<T> compare_type ; // change to std::greater<T> for min heap
+
+        // methods
+        /*!
+         * \brief Inserts a value in the sorted array, which
+         * must not be full.
+         * \param value the value to insert.
+         */
+        void sorted_insert(T value) ;
+        /*!
+         * \brief Removes the value at a given index of the
+         * sorted array.
+         * \param index the index of the value.
+         */
+        void sorted_remove(size_t index) ;
+        /*!
+         * \brief Removes the value at a given index of the heap
+         * and moves back to the array if the size is N/2.
+         * \param index the index of the value.
+         */
+        void heap_remove(index_type index) ;
+
+        /*!
+         * \brief Moves the elements from the sorted array to the
+         * heap, in O(N).
+         */
+        void grow() ;
+        /*!
+         * \brief Moves the elements from the heap back to the sorted
+         * array, keeping the heap storage.
+         */
+        void shrink() ;
+
+        // fields
+        /*!
+         * \brief The maximum size of the heap.
+         */
+        size_t _sizeMax ;
+        /*!
+         * \brief The number of elements in the sorted array.
+         */
+        size_t _size ;
+        /*!
+         * \brief Whether the elements are in the heap.
+         */
+        bool _grown ;
+        /*!
+         * \brief The number of switches between the representations.
+         */
+        size_t _switches ;
+        /*!
+         * \brief The inline array, sorted in ascending order.
+         */
+        std::array<T, N> _sorted ;
+        /*!
+         * \brief The d-ary heap, empty while the elements are
+         * in the array.
+         */
+        std::vector<T, Allocator> _heap ;
+} ;
+
+
+template<class T, size_t N, size_t Arity, class Allocator>
+adaptive_heap<T,N,Arity,Allocator>::adaptive_heap(size_t sizeMax, const Allocator& allocator)
+    : _sizeMax(sizeMax), _size(0), _grown(false), _switches(0), _sorted{}, _heap(allocator)
+{}
+
+template<class T, size_t N, size_t Arity, class Allocator>
+adaptive_heap<T,N,Arity,Allocator>::adaptive_heap(const std::vector<T>& v, const Allocator& allocator)
+    : _sizeMax(v.size()), _size(0), _grown(v.size() > N), _switches(0), _sorted{}, _heap(allocator)
+{	if(this->_grown)
+    {	this->_heap.assign(v.begin(), v.end()) ;
+        heap_make<Arity>(this->_heap.begin(), this->_heap.end(), compare_type()) ;
+    }
+    else
+    {	std::copy(v.begin(), v.end(), this->_sorted.begin()) ;
+        this->_size = v.size() ;
+        std::sort(this->_sorted.begin(), this->_sorted.begin() + this->_size, compare_type()) ;
+    }
+}
+
+
+template<class T, size_t N, size_t Arity, class Allocator>
+T adaptive_heap<T,N,Arity,Allocator>::top() const
+{	return this->_grown ? this->_heap[0] : this->_sorted[this->_size-1] ; }
+
+template<class T, size_t N, size_t Arity, class Allocator>
+T adaptive_heap<T,N,Arity,Allocator>::extract_top()
+{	if(not this->_grown)
+    {	this->_size-- ;
+        return std::move(this->_sorted[this->_size]) ;
+    }
+    T top = std::move(this->_heap[0]) ;
+    this->heap_remove(0) ;
+    return top ;
+}
+
+
+template<class T, size_t N, size_t Arity, class Allocator>
+void adaptive_heap<T,N,Arity,Allocator>::insert(T value)
+{	if(this->full())
+    {	throw std::runtime_error("adaptive_heap is full!") ; }
+
+    if((not this->_grown) and (this->_size == N))
+    {	this->grow() ; }
+    if(this->_grown)
+    {	index_type hole = this->_heap.size() ;
+        this->_heap.emplace_back() ;
+        heap_sift_up<Arity>(this->_heap.begin(), 0, hole, std::move(value), compare_type()) ;
+    }
+    else
+    {	this->sorted_insert(std::move(value)) ; }
+}
+
+template<class T, size_t N, size_t Arity, class Allocator>
+void adaptive_heap<T,N,Arity,Allocator>::remove(int index)
+{	if(this->_grown)
+    {	// move the hole to the top, as if the value had the maximum priority
+        index_type hole = index ;
+        while(hole > 0)
+        {	index_type parent = heap_parent<Arity>(hole) ;
+            this->_heap[hole] = std::move(this->_heap[parent]) ;
+            hole = parent ;
+        }
+        this->heap_remove(0) ;
+    }
+    else
+    {	this->sorted_remove(index) ; }
+}
+
+
+template<class T, size_t N, size_t Arity, class Allocator>
+void adaptive_heap<T,N,Arity,Allocator>::change_priority(int index, T priority)
+{	if(this->_grown)
+    {	if(compare_type()(this->_heap[index], priority))
+        {	heap_sift_up<Arity>(this->_heap.begin(), 0, index, std::move(priority), compare_type()) ; }
+        else
+        {	heap_sift_down<Arity>(this->_heap.begin(), this->_heap.size(), index, std::move(priority), compare_type()) ; }
+    }
+    else
+    {	this->sorted_remove(index) ;
+        this->sorted_insert(std::move(priority)) ;
+    }
+}
+
+
+template<class T, size_t N, size_t Arity, class Allocator>
+int adaptive_heap<T,N,Arity,Allocator>::find(T value) const
+{   const T* data = this->_grown ? this->_heap.data() : this->_sorted.data() ;
+    for(size_t i=0; i<this->size(); i++)
+    {   if(data[i] == value)
+        {   return i ; }
+    }
+    return -1 ;
+}
+
+
+template<class T, size_t N, size_t Arity, class Allocator>
+bool adaptive_heap<T,N,Arity,Allocator>::empty() const
+{	return this->size() == 0 ; }
+
+template<class T, size_t N, size_t Arity, class Allocator>
+bool adaptive_heap<T,N,Arity,Allocator>::full() const
+{	return this->size() == this->_sizeMax ; }
+
+template<class T, size_t N, size_t Arity, class Allocator>
+size_t adaptive_heap<T,N,Arity,Allocator>::size() const
+{	return this->_grown ? this->_heap.size() : this->_size ; }
+
+template<class T, size_t N, size_t Arity, class Allocator>
+bool adaptive_heap<T,N,Arity,Allocator>::sorted() const
+{	return not this->_grown ; }
+
+template<class T, size_t N, size_t Arity, class Allocator>
+size_t adaptive_heap<T,N,Arity,Allocator>::switches() const
+{	return this->_switches ; }
+
+
+template<class T, size_t N, size_t Arity, class Allocator>
+void adaptive_heap<T,N,Arity,Allocator>::sorted_insert(T value)
+{	auto first = this->_sorted.begin() ;
+    auto last = first + this->_size ;
+    auto position = std::upper_bound(first, last, value, compare_type()) ;
+    std::move_backward(position, last, last + 1) ;
+    *position = std::move(value) ;
+    this->_size++ ;
+}
+
+template<class T, size_t N, size_t Arity, class Allocator>
+void adaptive_heap<T,N,Arity,Allocator>::sorted_remove(size_t index)
+{	auto first = this->_sorted.begin() ;
+    std::move(first + index + 1, first + this->_size, first + index) ;
+    this->_size-- ;
+}
+
+template<class T, size_t N, size_t Arity, class Allocator>
+void adaptive_heap<T,N,Arity,Allocator>::heap_remove(index_type index)
+{	index_type len = this->_heap.size() - 1 ;
+    if(index < len)
+    {	heap_sift_down_floyd<Arity>(this->_heap.begin(), len, index, std::move(this->_heap[len]), compare_type()) ; }
+    this->_heap.pop_back() ;
+    if(this->_heap.size() <= N/2)
+    {	this->shrink() ; }
+}
+
+
+template<class T, size_t N, size_t Arity, class Allocator>
+void adaptive_heap<T,N,Arity,Allocator>::grow()
+{	// the capacity is kept when shrinking, such that this only allocates once
+    this->_heap.reserve(2*N) ;
+    // in descending order, each element is greater than its children
+    for(size_t i=this->_size; i>0; i--)
+    {	this->_heap.push_back(std::move(this->_sorted[i-1])) ; }
+    this->_size = 0 ;
+    this->_grown = true ;
+    this->_switches++ ;
+}
+
+template<class T, size_t N, size_t Arity, class Allocator>
+void adaptive_heap<T,N,Arity,Allocator>::shrink()
+{	this->_size = this->_heap.size() ;
+    std::move(this->_heap.begin(), this->_heap.end(), this->_sorted.begin()) ;
+    // at most N/2 elements
+    std::sort(this->_sorted.begin(), this->_sorted.begin() + this->_size, compare_type()) ;
+    this->_heap.clear() ;
+    this->_grown = false ;
+    this->_switches++ ;
+}
+
+
+template<class T, size_t N, size_t Arity, class Allocator>
+std::ostream& operator << (std::ostream& stream, const adaptive_heap<T,N,Arity,Allocator>& h)
+{	const T* data = h._grown ? h._heap.data() : h._sorted.data() ;
+    for(size_t i=0; i<h.size(); i++)
+    {	stream << data[i] << ' ' ; }
+    return stream ;
+}
+
+#endif // ADAPTIVE_HEAP_HPP
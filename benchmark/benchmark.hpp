@@ -0,0 +1,211 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Utilities shared by the benchmarks : timing, key generation and
+ * result printing.
+ */
+
+
+/*!
+ * \brief The stopwatch class measures the wall time elapsed since
+ * its construction or its last restart.
+ */
+class stopwatch
+{
+    public:
+        stopwatch()
+            : _start(std::chrono::steady_clock::now())
+        {}
+
+        /*!
+         * \brief Restarts the measure.
+         */
+        void restart()
+        {	this->_start = std::chrono::steady_clock::now() ; }
+
+        /*!
+         * \brief Returns the time elapsed since the start.
+         * \return the elapsed time in nanoseconds.
+         */
+        double elapsed_ns() const
+        {	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - this->_start).count() ; }
+
+    private:
+        std::chrono::steady_clock::time_point _start ;
+} ;
+
+
+/*!
+ * \brief Prevents the compiler from optimizing away the computation
+ * of a value.
+ * \param value the value of interest.
+ */
+template<class T>
+inline void do_not_optimize(const T& value)
+{	asm volatile("" : : "r,m"(value) : "memory") ; }
+
+
+/*!
+ * \brief A 64 bytes record ordered on its key, the payload being
+ * copied along.
+ */
+struct record64
+{	std::int64_t key ;
+    char payload[56] ;
+} ;
+
+inline bool operator < (const record64& a, const record64& b)
+{	return a.key < b.key ; }
+inline bool operator > (const record64& a, const record64& b)
+{	return a.key > b.key ; }
+inline bool operator == (const record64& a, const record64& b)
+{	return a.key == b.key ; }
+
+inline std::ostream& operator << (std::ostream& stream, const record64& r)
+{	return stream << r.key ; }
+
+
+/*!
+ * \brief The number of comparisons performed on counted values.
+ */
+inline size_t comparisons = 0 ;
+
+/*!
+ * \brief A value which comparisons are counted.
+ */
+struct counted
+{	int value ;
+} ;
+
+inline bool operator < (const counted& a, const counted& b)
+{	comparisons++ ;
+    return a.value < b.value ;
+}
+inline bool operator > (const counted& a, const counted& b)
+{	comparisons++ ;
+    return a.value > b.value ;
+}
+inline bool operator == (const counted& a, const counted& b)
+{	return a.value == b.value ; }
+
+
+inline std::ostream& operator << (std::ostream& stream, const counted& c)
+{	return stream << c.value ; }
+
+
+/*!
+ * \brief Draws a random key of the given type.
+ * \param generator the random generator.
+ * \return a random key.
+ */
+template<class T>
+T random_key(std::mt19937_64& generator) ;
+
+template<>
+inline int random_key<int>(std::mt19937_64& generator)
+{	return static_cast<int>(generator() >> 33) ; }
+
+template<>
+inline double random_key<double>(std::mt19937_64& generator)
+{	return std::uniform_real_distribution<double>(0., 1.)(generator) ; }
+
+template<>
+inline std::pair<int,int> random_key<std::pair<int,int>>(std::mt19937_64& generator)
+{	return std::make_pair(static_cast<int>(generator() >> 50), static_cast<int>(generator() >> 33)) ; }
+
+template<>
+inline record64 random_key<record64>(std::mt19937_64& generator)
+{	record64 r ;
+    r.key = static_cast<std::int64_t>(generator() >> 1) ;
+    std::memset(r.payload, static_cast<int>(r.key & 0xff), sizeof(r.payload)) ;
+    return r ;
+}
+
+/*!
+ * \brief Draws a vector of random keys.
+ * \param n the number of keys.
+ * \param seed the seed of the random generator.
+ * \return the keys.
+ */
+template<class T>
+std::vector<T> random_keys(size_t n, std::uint64_t seed = 42)
+{	std::mt19937_64 generator(seed) ;
+    std::vector<T> keys(n) ;
+    for(auto& key : keys)
+    {	key = random_key<T>(generator) ; }
+    return keys ;
+}
+
+/*!
+ * \brief Returns a printable name for the key types.
+ */
+template<class T> inline const char* key_name() ;
+template<> inline const char* key_name<std::int16_t>() { return "int16" ; }
+template<> inline const char* key_name<int>() { return "int" ; }
+template<> inline const char* key_name<unsigned>() { return "unsigned" ; }
+template<> inline const char* key_name<std::int64_t>() { return "int64" ; }
+template<> inline const char* key_name<std::uint64_t>() { return "uint64" ; }
+template<> inline const char* key_name<float>() { return "float" ; }
+template<> inline const char* key_name<double>() { return "double" ; }
+template<> inline const char* key_name<std::pair<int,int>>() { return "pair" ; }
+template<> inline const char* key_name<record64>() { return "record64" ; }
+
+
+/*!
+ * \brief Runs a function on a fresh copy of the data several times and
+ * returns the best time per element.
+ * \param data the data, copied before each run.
+ * \param function the function to time, taking a std::vector<T>&.
+ * \param repetitions the number of runs.
+ * \return the best time per element, in nanoseconds.
+ */
+template<class T, class F>
+double time_per_element(const std::vector<T>& data, F function, size_t repetitions)
+{	double best = std::numeric_limits<double>::max() ;
+    for(size_t i=0; i<repetitions; i++)
+    {	std::vector<T> copy(data) ;
+        stopwatch watch ;
+        function(copy) ;
+        double elapsed = watch.elapsed_ns() ;
+        do_not_optimize(copy.data()) ;
+        best = std::min(best, elapsed) ;
+    }
+    return best / std::max<size_t>(data.size(), 1) ;
+}
+
+/*!
+ * \brief Returns a number of repetitions such that about 10^6
+ * elements are processed, with at least 3 repetitions.
+ * \param n the number of elements per repetition.
+ * \return the number of repetitions.
+ */
+inline size_t repetitions(size_t n)
+{	return std::max<size_t>(3, 1000000 / std::max<size_t>(n, 1)) ; }
+
+/*!
+ * \brief Parses the size limit given as first argument.
+ * \param argc the number of arguments.
+ * \param argv the arguments.
+ * \param fallback the limit when none is given.
+ * \return the size limit.
+ */
+inline size_t max_size_argument(int argc, char** argv, size_t fallback)
+{	if(argc > 1)
+    {	return std::stoull(argv[1]) ; }
+    return fallback ;
+}
+
+#endif // BENCHMARK_HPP
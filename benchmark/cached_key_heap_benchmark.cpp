@@ -0,0 +1,197 @@
+/*
+ * Compares cached_key_heap with binary_heap given the same key function
+ * (heap_key.hpp), which calls it at each comparison, on n insertions
+ * followed by n extractions of orders ranked by a computed score.
+ * Before the timings, cached_key_heap is checked against a std::multiset of
+ * the scores : the cached key of the top must be the score of the top after
+ * each insertion, removal and priority change, the key function must be
+ * called once per insertion or change and never by the sifts, and the heap
+ * must drain in decreasing score order, the program returning 1 otherwise.
+ * Usage : cached_key_heap_benchmark [max size], the default being 10^6.
+ * The times are given in nanoseconds per operation.
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "cached_key_heap.hpp"
+
+#include <cmath>
+#include <set>
+
+
+/*!
+ * \brief An order, ranked by its discounted and weighted value.
+ */
+struct order
+{	int quantity ;
+    int price ;
+    double discount ;
+    double weight ;
+} ;
+
+inline bool operator == (const order& a, const order& b)
+{	return (a.quantity == b.quantity) and (a.price == b.price) and (a.discount == b.discount) and (a.weight == b.weight) ; }
+
+inline std::ostream& operator << (std::ostream& stream, const order& o)
+{	return stream << o.quantity << 'x' << o.price ; }
+
+/*!
+ * \brief The number of scores computed.
+ */
+inline size_t scores = 0 ;
+
+/*!
+ * \brief Computes the score of an order, counting the calls if Counted.
+ */
+template<bool Counted>
+struct score_key
+{	double operator () (const order& o) const
+    {	if(Counted)
+        {	scores++ ; }
+        return std::log1p(o.quantity * o.price * (1. - o.discount)) * o.weight ;
+    }
+} ;
+
+/*!
+ * \brief Draws random orders.
+ * \param n the number of orders.
+ * \param seed the seed of the random generator.
+ * \return the orders.
+ */
+std::vector<order> random_orders(size_t n, std::uint64_t seed)
+{	std::mt19937_64 generator(seed) ;
+    std::vector<order> orders(n) ;
+    for(order& o : orders)
+    {	o.quantity = static_cast<int>(generator() % 100) + 1 ;
+        o.price = static_cast<int>(generator() % 10000) ;
+        o.discount = (generator() % 50) / 100. ;
+        o.weight = std::uniform_real_distribution<double>(0.5, 2.)(generator) ;
+    }
+    return orders ;
+}
+
+
+/*!
+ * \brief Checks the cached key of the top of a heap against the key
+ * function and the largest score of a reference.
+ * \return whether they agree.
+ */
+template<class Heap>
+bool same_top(const Heap& heap, const std::multiset<double>& reference)
+{	if(heap.empty() or reference.empty())
+    {	return heap.empty() and reference.empty() ; }
+    bool same = (heap.top_key() == score_key<false>()(heap.top())) and (heap.top_key() == *reference.rbegin()) ;
+    if(not same)
+    {	std::cerr << "top key " << heap.top_key() << " for a score of " << score_key<false>()(heap.top())
+                  << ", " << *reference.rbegin() << " expected" << std::endl ;
+    }
+    return same ;
+}
+
+/*!
+ * \brief Inserts orders, removes and changes orders found in the heap, then
+ * drains it, checking it against a multiset of the scores and counting the
+ * calls to the key function.
+ * \return whether the checks passed.
+ */
+bool check_cached_keys()
+{	typedef cached_key_heap<order, score_key<true>> heap_type ;
+    std::mt19937_64 generator(11) ;
+    std::vector<order> orders = random_orders(2000, 12) ;
+    std::vector<order> changes = random_orders(500, 13) ;
+    heap_type heap(orders.size()) ;
+    std::multiset<double> reference ;
+    std::vector<order> present ;
+
+    scores = 0 ;
+    size_t expected = 0 ;
+    for(const order& o : orders)
+    {	heap.insert(o) ;
+        reference.insert(score_key<false>()(o)) ;
+        present.push_back(o) ;
+        expected++ ;
+        if(not same_top(heap, reference))
+        {	return false ; }
+    }
+
+    for(size_t i=0; i<changes.size(); i++)
+    {	size_t j = generator() % present.size() ;
+        // find() computes the key of the value searched
+        int index = heap.find(present[j]) ;
+        expected++ ;
+        if(index < 0)
+        {	std::cerr << "order " << present[j] << " not found" << std::endl ;
+            return false ;
+        }
+        reference.erase(reference.find(score_key<false>()(present[j]))) ;
+        if(i % 2 == 0)
+        {	heap.remove(index) ;
+            present[j] = present.back() ;
+            present.pop_back() ;
+        }
+        else
+        {	heap.change_priority(index, changes[i]) ;
+            reference.insert(score_key<false>()(changes[i])) ;
+            present[j] = changes[i] ;
+            expected++ ;
+        }
+        if(not same_top(heap, reference))
+        {	return false ; }
+    }
+
+    while(not heap.empty())
+    {	heap.extract_top() ;
+        reference.erase(std::prev(reference.end())) ;
+        if(not same_top(heap, reference))
+        {	return false ; }
+    }
+    if(scores != expected)
+    {	std::cerr << scores << " keys computed, " << expected << " expected" << std::endl ;
+        return false ;
+    }
+    std::cout << "cached_key_heap checked" << std::endl ;
+    return true ;
+}
+
+
+/*!
+ * \brief Inserts the orders, then extracts them all.
+ * \param heap the heap, initially empty.
+ * \param orders the orders.
+ * \return the number of operations.
+ */
+template<class Heap>
+size_t drain(Heap& heap, const std::vector<order>& orders)
+{	for(const order& o : orders)
+    {	heap.insert(o) ; }
+    while(not heap.empty())
+    {	do_not_optimize(heap.extract_top()) ; }
+    return 2*orders.size() ;
+}
+
+template<class Heap>
+void benchmark(const char* name, const std::vector<order>& orders)
+{	Heap heap(orders.size()) ;
+    stopwatch watch ;
+    size_t operations = drain(heap, orders) ;
+    double elapsed = watch.elapsed_ns() ;
+    std::cout << std::setw(16) << name << std::setw(12) << orders.size()
+              << std::setw(12) << elapsed / operations << std::endl ;
+}
+
+
+int main(int argc, char** argv)
+{	size_t max_size = max_size_argument(argc, argv, 1000000) ;
+
+    if(not check_cached_keys())
+    {	return 1 ; }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(16) << "heap" << std::setw(12) << "n"
+              << std::setw(12) << "ns/op" << std::endl ;
+    for(size_t n=1000; n<=max_size; n*=10)
+    {	std::vector<order> orders = random_orders(n, 14) ;
+        benchmark<binary_heap<order, std::allocator<order>, null_instrumentation, score_key<false>>>("binary_heap", orders) ;
+        benchmark<cached_key_heap<order, score_key<false>>>("cached_key_heap", orders) ;
+    }
+    return 0 ;
+}
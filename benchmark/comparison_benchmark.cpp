@@ -0,0 +1,98 @@
+/*
+ * Counts the comparisons performed by weak_heap, binary_heap, heap_sort
+ * (heap_algorithm.hpp) and std::priority_queue, for heaps keyed on expensive
+ * comparators.
+ * Usage : comparison_benchmark [max size], the default being 10^6.
+ * The numbers of comparisons are given per element, and relatively to
+ * n log2(n) for the sorts.
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "weak_heap.hpp"
+#include "heap_algorithm.hpp"
+
+#include <cmath>
+#include <queue>
+
+
+/*!
+ * \brief Sorts the values by building a heap and extracting all its
+ * values.
+ * \return the number of comparisons.
+ */
+template<class Heap>
+size_t build_and_drain(const std::vector<counted>& values)
+{	comparisons = 0 ;
+    Heap heap(values) ;
+    while(not heap.empty())
+    {	do_not_optimize(heap.extract_top()) ; }
+    return comparisons ;
+}
+
+/*!
+ * \brief Inserts all the values one by one and extracts them all.
+ * \return the number of comparisons.
+ */
+template<class Heap>
+size_t insert_and_drain(const std::vector<counted>& values)
+{	comparisons = 0 ;
+    Heap heap(values.size()) ;
+    for(const auto& value : values)
+    {	heap.insert(value) ; }
+    while(not heap.empty())
+    {	do_not_optimize(heap.extract_top()) ; }
+    return comparisons ;
+}
+
+size_t heap_sort_comparisons(std::vector<counted> values)
+{	comparisons = 0 ;
+    heap_sort(values.begin(), values.end()) ;
+    return comparisons ;
+}
+
+size_t priority_queue_comparisons(const std::vector<counted>& values, bool build)
+{	comparisons = 0 ;
+    std::priority_queue<counted> heap ;
+    if(build)
+    {	heap = std::priority_queue<counted>(std::less<counted>(), values) ; }
+    else
+    {	for(const auto& value : values)
+        {	heap.push(value) ; }
+    }
+    while(not heap.empty())
+    {	do_not_optimize(heap.top()) ;
+        heap.pop() ;
+    }
+    return comparisons ;
+}
+
+
+void print(const char* workload, const char* heap, size_t n, size_t count)
+{	std::cout << std::setw(18) << workload << std::setw(14) << heap << std::setw(10) << n
+              << std::setw(12) << double(count) / n
+              << std::setw(12) << double(count) / (n * std::log2(double(n))) << std::endl ;
+}
+
+
+int main(int argc, char** argv)
+{	size_t max_size = max_size_argument(argc, argv, 1000000) ;
+
+    std::cout << std::fixed << std::setprecision(3)
+              << std::setw(18) << "workload" << std::setw(14) << "heap" << std::setw(10) << "n"
+              << std::setw(12) << "cmp/n" << std::setw(12) << "cmp/nlog2n" << std::endl ;
+    for(size_t n=1000; n<=max_size; n*=10)
+    {	std::vector<int> keys = random_keys<int>(n) ;
+        std::vector<counted> values(n) ;
+        for(size_t i=0; i<n; i++)
+        {	values[i].value = keys[i] ; }
+
+        print("build+drain", "weak_heap", n, build_and_drain<weak_heap<counted>>(values)) ;
+        print("build+drain", "binary_heap", n, build_and_drain<binary_heap<counted>>(values)) ;
+        print("build+drain", "heap_sort", n, heap_sort_comparisons(values)) ;
+        print("build+drain", "std::pq", n, priority_queue_comparisons(values, true)) ;
+        print("insert+drain", "weak_heap", n, insert_and_drain<weak_heap<counted>>(values)) ;
+        print("insert+drain", "binary_heap", n, insert_and_drain<binary_heap<counted>>(values)) ;
+        print("insert+drain", "std::pq", n, priority_queue_comparisons(values, false)) ;
+    }
+    return 0 ;
+}
@@ -0,0 +1,138 @@
+/*
+ * Compares counted_heap with binary_heap on the hold model with many
+ * duplicates : the keys are drawn among d distinct priorities, d going from
+ * 16 to the heap size.
+ * Before the timings, counted_heap is checked against a std::multiset : the
+ * insertions with a count, top(), top_count(), count(), distinct(), size()
+ * and the drained order, the program returning 1 if they disagree.
+ * Usage : counted_heap_benchmark [max size], the default being 10^6.
+ * The times are given in nanoseconds per operation.
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "counted_heap.hpp"
+
+#include <set>
+
+
+/*!
+ * \brief Checks the counters of a counted heap against a multiset.
+ * \param heap the heap.
+ * \param reference the multiset holding the same values.
+ * \param value a value which count is checked.
+ * \return whether they agree.
+ */
+bool same_counts(const counted_heap<int>& heap, const std::multiset<int>& reference, int value)
+{	size_t distinct = 0 ;
+    for(auto it = reference.begin(); it != reference.end(); it = reference.upper_bound(*it))
+    {	distinct++ ; }
+    bool same = (heap.size() == reference.size()) and (heap.distinct() == distinct)
+                and (heap.count(value) == reference.count(value)) ;
+    if(same and not reference.empty())
+    {	same = (heap.top() == *reference.rbegin()) and (heap.top_count() == reference.count(*reference.rbegin())) ; }
+    if(not same)
+    {	std::cerr << "counted_heap of size " << heap.size() << " and " << heap.distinct() << " distinct values disagrees on "
+                  << value << " (" << heap.count(value) << " occurrences, " << reference.count(value) << " expected)" << std::endl ;
+    }
+    return same ;
+}
+
+/*!
+ * \brief Inserts values with random counts among 50 distinct ones, mixed
+ * with extractions, then drains the heap, checking it against a multiset.
+ * \return whether the heap agrees with the multiset.
+ */
+bool check_counts()
+{	std::mt19937_64 generator(9) ;
+    counted_heap<int> heap(100000) ;
+    std::multiset<int> reference ;
+    for(size_t i=0; i<5000; i++)
+    {	int value = static_cast<int>(generator() % 50) ;
+        if((generator() % 3 == 0) and not reference.empty())
+        {	int top = heap.extract_top() ;
+            if(top != *reference.rbegin())
+            {	std::cerr << "extracted " << top << " instead of " << *reference.rbegin() << std::endl ;
+                return false ;
+            }
+            reference.erase(std::prev(reference.end())) ;
+        }
+        else
+        {	size_t count = generator() % 4 ;
+            heap.insert(value, count) ;
+            for(size_t c=0; c<count; c++)
+            {	reference.insert(value) ; }
+        }
+        if(not same_counts(heap, reference, value))
+        {	return false ; }
+    }
+
+    while(not reference.empty())
+    {	if(heap.extract_top() != *reference.rbegin())
+        {	std::cerr << "out of order while draining" << std::endl ;
+            return false ;
+        }
+        reference.erase(std::prev(reference.end())) ;
+        if(not same_counts(heap, reference, 0))
+        {	return false ; }
+    }
+
+    // the heap built from a vector merges the duplicates
+    std::vector<int> v = {3, 1, 3, 2, 3, 1} ;
+    counted_heap<int> built(v) ;
+    reference = std::multiset<int>(v.begin(), v.end()) ;
+    if(not same_counts(built, reference, 1))
+    {	return false ; }
+    std::cout << "counted_heap checked" << std::endl ;
+    return true ;
+}
+
+
+/*!
+ * \brief Runs the hold model : each operation extracts the top and inserts
+ * a key among the distinct ones.
+ * \param heap the heap, initially empty.
+ * \param n the number of elements.
+ * \param distinct the number of distinct keys.
+ * \return the number of operations.
+ */
+template<class Heap>
+size_t hold(Heap& heap, size_t n, size_t distinct)
+{	std::mt19937_64 generator(10) ;
+    for(size_t i=0; i<n; i++)
+    {	heap.insert(static_cast<int>(generator() % distinct)) ; }
+    size_t operations = std::max<size_t>(n, 1000000) ;
+    for(size_t i=0; i<operations; i++)
+    {	do_not_optimize(heap.extract_top()) ;
+        heap.insert(static_cast<int>(generator() % distinct)) ;
+    }
+    return 2*operations ;
+}
+
+template<class Heap>
+void benchmark(const char* name, size_t n, size_t distinct)
+{	Heap heap(n) ;
+    stopwatch watch ;
+    size_t operations = hold(heap, n, distinct) ;
+    double elapsed = watch.elapsed_ns() ;
+    std::cout << std::setw(14) << name << std::setw(12) << n << std::setw(12) << distinct
+              << std::setw(12) << elapsed / operations << std::endl ;
+}
+
+
+int main(int argc, char** argv)
+{	size_t max_size = max_size_argument(argc, argv, 1000000) ;
+
+    if(not check_counts())
+    {	return 1 ; }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(14) << "heap" << std::setw(12) << "n" << std::setw(12) << "distinct"
+              << std::setw(12) << "ns/op" << std::endl ;
+    for(size_t n=1000; n<=max_size; n*=10)
+    {	for(size_t distinct=16; distinct<=n; distinct*=16)
+        {	benchmark<binary_heap<int>>("binary_heap", n, distinct) ;
+            benchmark<counted_heap<int>>("counted_heap", n, distinct) ;
+        }
+    }
+    return 0 ;
+}
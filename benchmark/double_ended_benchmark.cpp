@@ -0,0 +1,104 @@
+/*
+ * Compares the double-ended priority queues, min_max_heap and
+ * interval_heap, on a bounded eviction workload : the queue serves its
+ * maximum and, when it is full, evicts its minimum to admit a larger value.
+ * A std::multiset is given as a reference.
+ * Usage : double_ended_benchmark [max capacity], the default being 10^6.
+ * The times are given in nanoseconds per operation, along with the number
+ * of comparisons per operation.
+ */
+#include "benchmark.hpp"
+#include "min_max_heap.hpp"
+#include "interval_heap.hpp"
+
+#include <set>
+
+
+/*!
+ * \brief Adapts std::multiset to the double-ended queue interface.
+ */
+template<class T>
+class multiset_queue
+{
+    public:
+        multiset_queue(size_t sizeMax) : _sizeMax(sizeMax) {}
+        T top_max() const { return *this->_set.rbegin() ; }
+        T top_min() const { return *this->_set.begin() ; }
+        T extract_max() { T v = *std::prev(this->_set.end()) ; this->_set.erase(std::prev(this->_set.end())) ; return v ; }
+        T extract_min() { T v = *this->_set.begin() ; this->_set.erase(this->_set.begin()) ; return v ; }
+        void insert(T value) { this->_set.insert(value) ; }
+        bool empty() const { return this->_set.empty() ; }
+        bool full() const { return this->_set.size() == this->_sizeMax ; }
+        size_t size() const { return this->_set.size() ; }
+    private:
+        size_t _sizeMax ;
+        std::multiset<T> _set ;
+} ;
+
+
+/*!
+ * \brief Runs the bounded eviction workload : every value of the
+ * stream is admitted if the queue is not full or if it is larger than
+ * the minimum, which is then evicted, and the maximum is served every
+ * four values.
+ * \param queue the queue, initially empty.
+ * \param stream the values.
+ * \return the number of operations.
+ */
+template<class Queue, class T>
+size_t bounded_eviction(Queue& queue, const std::vector<T>& stream)
+{	size_t operations = 0 ;
+    for(size_t i=0; i<stream.size(); i++)
+    {	if(not queue.full())
+        {	queue.insert(stream[i]) ;
+            operations++ ;
+        }
+        else if(queue.top_min() < stream[i])
+        {	do_not_optimize(queue.extract_min()) ;
+            queue.insert(stream[i]) ;
+            operations += 2 ;
+        }
+        if((i % 4 == 3) and not queue.empty())
+        {	do_not_optimize(queue.extract_max()) ;
+            operations++ ;
+        }
+    }
+    return operations ;
+}
+
+template<template<class, class...> class Queue>
+void benchmark(const char* name, size_t capacity)
+{	size_t n = std::max<size_t>(20*capacity, 1000000) ;
+    std::vector<int> stream = random_keys<int>(n) ;
+    std::vector<counted> counted_stream(n) ;
+    for(size_t i=0; i<n; i++)
+    {	counted_stream[i].value = stream[i] ; }
+
+    Queue<int> queue(capacity) ;
+    stopwatch watch ;
+    size_t operations = bounded_eviction(queue, stream) ;
+    double elapsed = watch.elapsed_ns() ;
+
+    Queue<counted> counted_queue(capacity) ;
+    comparisons = 0 ;
+    bounded_eviction(counted_queue, counted_stream) ;
+
+    std::cout << std::setw(14) << name << std::setw(12) << capacity
+              << std::setw(12) << elapsed / operations
+              << std::setw(12) << double(comparisons) / operations << std::endl ;
+}
+
+
+int main(int argc, char** argv)
+{	size_t max_capacity = max_size_argument(argc, argv, 1000000) ;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(14) << "queue" << std::setw(12) << "capacity"
+              << std::setw(12) << "ns/op" << std::setw(12) << "cmp/op" << std::endl ;
+    for(size_t capacity=100; capacity<=max_capacity; capacity*=10)
+    {	benchmark<min_max_heap>("min_max_heap", capacity) ;
+        benchmark<interval_heap>("interval_heap", capacity) ;
+        benchmark<multiset_queue>("std::multiset", capacity) ;
+    }
+    return 0 ;
+}
@@ -0,0 +1,168 @@
+/*
+ * Compares encoded_key_heap, which compares the order-preserving integer
+ * codes of its keys, with dary_heap comparing the keys, on n insertions
+ * followed by n extractions of random float and double keys.
+ * Before the timings, heaps of float and double keys mixing NaNs (of both
+ * signs, quiet and signaling, with payloads), infinities, zeros of both signs,
+ * subnormals and random values are drained, and the extracted keys are
+ * checked bit for bit against the IEEE-754 totalOrder, computed without the
+ * encoding, the program returning 1 otherwise.
+ * Usage : encoded_key_heap_benchmark [max size], the default being 10^6.
+ * The times are given in nanoseconds per operation.
+ */
+#include "benchmark.hpp"
+#include "dary_heap.hpp"
+#include "encoded_key_heap.hpp"
+
+#include <cmath>
+
+
+/*!
+ * \brief The unsigned integer of the size of a floating point type.
+ */
+template<class T>
+using bits_type = typename std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t>::type ;
+
+template<class T>
+bits_type<T> bits_of(T value)
+{	bits_type<T> bits ;
+    std::memcpy(&bits, &value, sizeof(bits)) ;
+    return bits ;
+}
+
+template<class T>
+T from_bits(bits_type<T> bits)
+{	T value ;
+    std::memcpy(&value, &bits, sizeof(value)) ;
+    return value ;
+}
+
+/*!
+ * \brief Returns the class of a value in the totalOrder : the negative NaNs,
+ * the negative numbers, -0, +0, the positive numbers and the positive NaNs.
+ */
+template<class T>
+int total_order_class(T value)
+{	if(std::isnan(value))
+    {	return std::signbit(value) ? 0 : 5 ; }
+    if(value == 0)
+    {	return std::signbit(value) ? 2 : 3 ; }
+    return value < 0 ? 1 : 4 ;
+}
+
+/*!
+ * \brief The totalOrder predicate of IEEE-754 : the NaNs are ordered by
+ * payload, the negative ones in reverse.
+ */
+template<class T>
+bool total_order_less(T a, T b)
+{	int class_a = total_order_class(a) ;
+    int class_b = total_order_class(b) ;
+    if(class_a != class_b)
+    {	return class_a < class_b ; }
+    if(std::isnan(a))
+    {	const bits_type<T> payload = (bits_type<T>(1) << (std::numeric_limits<T>::digits - 1)) - 1 ;
+        bits_type<T> payload_a = bits_of(a) & payload ;
+        bits_type<T> payload_b = bits_of(b) & payload ;
+        return class_a == 5 ? payload_a < payload_b : payload_a > payload_b ;
+    }
+    return a < b ;
+}
+
+/*!
+ * \brief Drains a heap of special and random values and compares the
+ * extracted keys with the values sorted by decreasing totalOrder.
+ * \return whether the keys come out in the totalOrder.
+ */
+template<class T>
+bool check_total_order()
+{	typedef bits_type<T> bits ;
+    const bits sign = bits(1) << (8*sizeof(T) - 1) ;
+    const bits quiet = bits(1) << (std::numeric_limits<T>::digits - 2) ;
+    const bits exponent = bits_of(std::numeric_limits<T>::infinity()) ;
+    std::vector<T> values = {
+        std::numeric_limits<T>::quiet_NaN(), -std::numeric_limits<T>::quiet_NaN(),
+        from_bits<T>(exponent | quiet | 5), from_bits<T>(sign | exponent | quiet | 5),
+        from_bits<T>(exponent | 1), from_bits<T>(sign | exponent | 3),
+        std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(),
+        T(0), -T(0), T(0), -T(0),
+        std::numeric_limits<T>::denorm_min(), -std::numeric_limits<T>::denorm_min(),
+        std::numeric_limits<T>::min(), -std::numeric_limits<T>::min(),
+        std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest(),
+        T(1), T(-1), T(1)
+    } ;
+    std::mt19937_64 generator(16) ;
+    for(size_t i=0; i<1000; i++)
+    {	values.push_back(static_cast<T>(std::uniform_real_distribution<double>(-1e3, 1e3)(generator))) ; }
+
+    encoded_key_heap<T> heap(values.size()) ;
+    for(T value : values)
+    {	heap.insert(value) ; }
+    if((heap.find(from_bits<T>(sign | exponent | quiet | 5)) < 0) or (heap.find(-T(0)) < 0))
+    {	std::cerr << "encoded_key_heap<" << key_name<T>() << "> did not find a NaN or -0" << std::endl ;
+        return false ;
+    }
+
+    std::sort(values.begin(), values.end(), [](T a, T b) { return total_order_less(b, a) ; }) ;
+    for(T expected : values)
+    {	T key = heap.extract_top() ;
+        if(bits_of(key) != bits_of(expected))
+        {	std::cerr << "encoded_key_heap<" << key_name<T>() << "> extracted " << key << " (0x" << std::hex << bits_of(key)
+                      << ") instead of " << expected << " (0x" << bits_of(expected) << ')' << std::dec << std::endl ;
+            return false ;
+        }
+    }
+    return heap.empty() ;
+}
+
+
+/*!
+ * \brief Inserts the keys, then extracts them all.
+ * \param heap the heap, initially empty.
+ * \param keys the keys.
+ * \return the number of operations.
+ */
+template<class Heap, class T>
+size_t drain(Heap& heap, const std::vector<T>& keys)
+{	for(T key : keys)
+    {	heap.insert(key) ; }
+    while(not heap.empty())
+    {	do_not_optimize(heap.extract_top()) ; }
+    return 2*keys.size() ;
+}
+
+template<class Heap, class T>
+void benchmark(const char* name, const std::vector<T>& keys)
+{	Heap heap(keys.size()) ;
+    stopwatch watch ;
+    size_t operations = drain(heap, keys) ;
+    double elapsed = watch.elapsed_ns() ;
+    std::cout << std::setw(18) << name << std::setw(10) << key_name<T>() << std::setw(12) << keys.size()
+              << std::setw(12) << elapsed / operations << std::endl ;
+}
+
+template<class T>
+void benchmark(size_t max_size)
+{	for(size_t n=1000; n<=max_size; n*=10)
+    {	std::vector<double> doubles = random_keys<double>(n) ;
+        std::vector<T> keys(doubles.begin(), doubles.end()) ;
+        benchmark<dary_heap<T>>("dary_heap", keys) ;
+        benchmark<encoded_key_heap<T>>("encoded_key_heap", keys) ;
+    }
+}
+
+
+int main(int argc, char** argv)
+{	size_t max_size = max_size_argument(argc, argv, 1000000) ;
+
+    if(not (check_total_order<float>() and check_total_order<double>()))
+    {	return 1 ; }
+    std::cout << "totalOrder checked" << std::endl ;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(18) << "heap" << std::setw(10) << "key" << std::setw(12) << "n"
+              << std::setw(12) << "ns/op" << std::endl ;
+    benchmark<float>(max_size) ;
+    benchmark<double>(max_size) ;
+    return 0 ;
+}
@@ -0,0 +1,202 @@
+/*
+ * Runs a workload against binary_heap and every configuration of dary_heap
+ * (arity 2, 4 or 8, standard or Floyd extraction, branchy or branchless
+ * child selection, with or without prefetching) and emits the fastest as a
+ * generated header defining the tuned_heap<T> alias template, such that a
+ * build can bake in the winner for the machine it runs on.
+ * Usage : heap_autotune <trace | hold | drain | mixed> [n] [-o header]
+ *  - trace : a trace recorded with recording_heap (heap_trace.hpp),
+ *  - hold, drain, mixed : synthetic profiles of int keys on a heap of size n
+ *    (10^5 by default), see heap_benchmark.cpp and heap_replay.cpp.
+ * The header is written to the given path, or to the standard output.
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "dary_heap.hpp"
+#include "heap_trace.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+
+/*!
+ * \brief The fastest configuration found so far.
+ */
+struct tuning_result
+{	std::string type ;
+    double ns_per_op = 0. ;
+} ;
+
+/*!
+ * \brief Replays the operations 3 times against a heap type and keeps
+ * it if it is the fastest so far.
+ * \param type the C++ type of the heap, T standing for the key type.
+ */
+template<class Heap, class T>
+void candidate(const std::string& type, const std::vector<trace_event<T>>& events,
+               size_t capacity, tuning_result& best)
+{	double fastest = 0. ;
+    size_t operations = 0 ;
+    for(int i=0; i<3; i++)
+    {	Heap heap(capacity) ;
+        stopwatch watch ;
+        operations = replay_trace(events, heap) ;
+        double elapsed = watch.elapsed_ns() ;
+        if((i == 0) or (elapsed < fastest))
+        {	fastest = elapsed ; }
+    }
+    double ns = fastest / operations ;
+    std::cerr << std::setw(66) << std::left << type << std::right << std::setw(10) << ns << " ns/op" << std::endl ;
+    if(best.type.empty() or (ns < best.ns_per_op))
+    {	best.type = type ;
+        best.ns_per_op = ns ;
+    }
+}
+
+template<class T, size_t Arity, heap_sift Sift>
+void candidates(const std::vector<trace_event<T>>& events, size_t capacity, tuning_result& best)
+{	std::string prefix = "dary_heap<T, heap_config<" + std::to_string(Arity)
+                         + (Sift == heap_sift::floyd ? ", heap_sift::floyd" : ", heap_sift::standard") ;
+    candidate<dary_heap<T, heap_config<Arity, Sift, false, false>>>(prefix + ", false, false>>", events, capacity, best) ;
+    candidate<dary_heap<T, heap_config<Arity, Sift, false, true>>>(prefix + ", false, true>>", events, capacity, best) ;
+    candidate<dary_heap<T, heap_config<Arity, Sift, true, false>>>(prefix + ", true, false>>", events, capacity, best) ;
+    candidate<dary_heap<T, heap_config<Arity, Sift, true, true>>>(prefix + ", true, true>>", events, capacity, best) ;
+}
+
+/*!
+ * \brief Runs all the configurations.
+ * \return the fastest.
+ */
+template<class T>
+tuning_result tune(const std::vector<trace_event<T>>& events, size_t capacity)
+{	tuning_result best ;
+    std::cerr << std::fixed << std::setprecision(2) ;
+    candidate<binary_heap<T>>("binary_heap<T>", events, capacity, best) ;
+    candidates<T, 2, heap_sift::standard>(events, capacity, best) ;
+    candidates<T, 2, heap_sift::floyd>(events, capacity, best) ;
+    candidates<T, 4, heap_sift::standard>(events, capacity, best) ;
+    candidates<T, 4, heap_sift::floyd>(events, capacity, best) ;
+    candidates<T, 8, heap_sift::standard>(events, capacity, best) ;
+    candidates<T, 8, heap_sift::floyd>(events, capacity, best) ;
+    return best ;
+}
+
+template<class T>
+tuning_result tune(std::istream& stream)
+{	trace_reader<T> reader(stream) ;
+    std::vector<trace_event<T>> events = read_trace(reader) ;
+    return tune(events, reader.header().capacity) ;
+}
+
+
+/*!
+ * \brief Records a synthetic profile in memory.
+ * \return the trace.
+ */
+std::string synthesize(const std::string& profile, size_t n)
+{	std::ostringstream stream ;
+    recording_heap<binary_heap<int>, int> heap(n, stream) ;
+    std::mt19937_64 generator(5) ;
+    std::vector<int> keys = random_keys<int>(n) ;
+    if(profile != "mixed")
+    {	for(int key : keys)
+        {	heap.insert(key) ; }
+    }
+    for(size_t i=0; i<10*n; i++)
+    {	int key = random_key<int>(generator) ;
+        size_t choice = generator() % 8 ;
+        if(profile == "drain")
+        {	if(heap.empty())
+            {	for(int k : keys)
+                {	heap.insert(k) ; }
+            }
+            heap.extract_top() ;
+        }
+        else if(profile == "hold")
+        {	int top = heap.extract_top() ;
+            heap.insert(top - static_cast<int>(generator() % 1000)) ;
+        }
+        else if(heap.empty() or ((choice < 4) and not heap.full()))
+        {	heap.insert(key) ; }
+        else if(choice < 6)
+        {	heap.extract_top() ; }
+        else if(choice < 7)
+        {	heap.remove(generator() % heap.size()) ; }
+        else
+        {	heap.change_priority(generator() % heap.size(), key) ; }
+    }
+    return stream.str() ;
+}
+
+
+int main(int argc, char** argv)
+{	std::vector<std::string> args(argv + 1, argv + argc) ;
+    std::string output ;
+    for(size_t i=0; i+1<args.size(); i++)
+    {	if(args[i] == "-o")
+        {	output = args[i+1] ;
+            args.erase(args.begin() + i, args.begin() + i + 2) ;
+            break ;
+        }
+    }
+    if(args.empty())
+    {	std::cerr << "usage : heap_autotune <trace | hold | drain | mixed> [n] [-o header]" << std::endl ;
+        return 1 ;
+    }
+
+    tuning_result best ;
+    try
+    {	const std::string& source = args[0] ;
+        if((source == "hold") or (source == "drain") or (source == "mixed"))
+        {	std::istringstream stream(synthesize(source, args.size() > 1 ? std::stoul(args[1]) : 100000)) ;
+            best = tune<int>(stream) ;
+        }
+        else
+        {	std::ifstream stream(source, std::ios::binary) ;
+            if(not stream)
+            {	std::cerr << "cannot open " << source << std::endl ;
+                return 1 ;
+            }
+            char tag = trace_header::read(stream).key_tag ;
+            stream.seekg(0) ;
+            switch(tag)
+            {	case 'i' : best = tune<int>(stream) ; break ;
+                case 'u' : best = tune<unsigned>(stream) ; break ;
+                case 'l' : best = tune<int64_t>(stream) ; break ;
+                case 'q' : best = tune<uint64_t>(stream) ; break ;
+                case 'f' : best = tune<float>(stream) ; break ;
+                case 'd' : best = tune<double>(stream) ; break ;
+                default :
+                    std::cerr << "unsupported key type" << std::endl ;
+                    return 1 ;
+            }
+        }
+    }
+    catch(const std::exception& e)
+    {	std::cerr << e.what() << std::endl ;
+        return 1 ;
+    }
+
+    std::ostringstream header ;
+    header << "// Generated by heap_autotune for " << args[0] << " : " << best.ns_per_op
+           << " ns per operation." << std::endl
+           << "#ifndef TUNED_HEAP_HPP" << std::endl
+           << "#define TUNED_HEAP_HPP" << std::endl << std::endl
+           << "#include \"binary_heap.hpp\"" << std::endl
+           << "#include \"dary_heap.hpp\"" << std::endl << std::endl
+           << "template<class T>" << std::endl
+           << "using tuned_heap = " << best.type << " ;" << std::endl << std::endl
+           << "#endif // TUNED_HEAP_HPP" << std::endl ;
+    if(output.empty())
+    {	std::cout << header.str() ; }
+    else
+    {	std::ofstream file(output) ;
+        file << header.str() ;
+        if(not file)
+        {	std::cerr << "cannot write " << output << std::endl ;
+            return 1 ;
+        }
+    }
+    return 0 ;
+}
@@ -0,0 +1,580 @@
+/*
+ * Benchmark suite comparing binary_heap with std::priority_queue and the
+ * other heaps of the repository on standard workloads :
+ *  - hold : the hold model, each operation extracting the top and inserting
+ *    a value slightly lower (the maximum heap being used as a time queue),
+ *  - drain : n insertions followed by n extractions,
+ *  - dijkstra : the trace of a Dijkstra run with lazy deletion on a random
+ *    graph (out-degree 2) : each improved distance is inserted without
+ *    removing the previous one, which is extracted later and skipped as stale,
+ *  - topk : the n smallest values of a stream of 10n values,
+ *  - mixed : priority updates and cancellations by index mixed with hold
+ *    operations (only for the heaps supporting them).
+ * The sizes go from 10 to the given maximum and the key types are int,
+ * double, std::pair<int,int> and a 64 bytes record.
+ * Usage : heap_benchmark [max size] [workload], the default maximum size
+ * being 10^6, all the workloads being run by default.
+ * The throughput is measured on a first run and the latency percentiles of
+ * the operations on a second run, timing a sample of the operations.
+ * Finally, the latency histograms of binary_heap (latency_instrumentation) are
+ * reported per operation for the hold and mixed workloads, with the overhead
+ * of the instrumentation.
+ * When the hardware counters are available (perf_counters.hpp), the L1D, LLC
+ * and dTLB misses and the branch misses per operation are reported for each
+ * run and per operation kind for binary_heap (perf_instrumentation).
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "weak_heap.hpp"
+#include "adaptive_heap.hpp"
+#include "latency_instrumentation.hpp"
+#include "perf_counters.hpp"
+
+#include <algorithm>
+#include <array>
+#include <functional> // greater
+#include <queue>
+
+
+/*!
+ * \brief Returns a key lower than the given key by a random amount.
+ */
+inline int lower_key(int key, std::mt19937_64& generator)
+{	int delta = static_cast<int>(generator() % 1000) ;
+    return key > std::numeric_limits<int>::min() + delta ? key - delta : key ;
+}
+
+inline double lower_key(double key, std::mt19937_64& generator)
+{	return key - std::uniform_real_distribution<double>(0., 0.001)(generator) ; }
+
+inline std::pair<int,int> lower_key(const std::pair<int,int>& key, std::mt19937_64& generator)
+{	return std::make_pair(lower_key(key.first, generator), static_cast<int>(generator() >> 33)) ; }
+
+inline record64 lower_key(const record64& key, std::mt19937_64& generator)
+{	record64 r = key ;
+    std::int64_t delta = static_cast<std::int64_t>(generator() % 1000) ;
+    r.key = key.key > std::numeric_limits<std::int64_t>::min() + delta ? key.key - delta : key.key ;
+    return r ;
+}
+
+
+/*!
+ * \brief Adapts binary_heap to the interface used by the workloads.
+ */
+template<class T, class Instrumentation = null_instrumentation>
+class binary_heap_adapter
+{
+    public:
+        static constexpr bool indexed = true ;
+        static const char* name() { return "binary_heap" ; }
+        binary_heap_adapter(size_t capacity) : _heap(capacity) {}
+        void push(const T& value) { this->_heap.insert(value) ; }
+        T pop() { return this->_heap.extract_top() ; }
+        T top() const { return this->_heap.top() ; }
+        bool empty() const { return this->_heap.empty() ; }
+        size_t size() const { return this->_heap.size() ; }
+        void update(size_t index, const T& value) { this->_heap.change_priority(index, value) ; }
+        void cancel(size_t index) { this->_heap.remove(index) ; }
+        const Instrumentation& instrumentation() const { return this->_heap.instrumentation() ; }
+    private:
+        binary_heap<T, std::allocator<T>, Instrumentation> _heap ;
+} ;
+
+/*!
+ * \brief Adapts weak_heap to the interface used by the workloads.
+ */
+template<class T>
+class weak_heap_adapter
+{
+    public:
+        static constexpr bool indexed = true ;
+        static const char* name() { return "weak_heap" ; }
+        weak_heap_adapter(size_t capacity) : _heap(capacity) {}
+        void push(const T& value) { this->_heap.insert(value) ; }
+        T pop() { return this->_heap.extract_top() ; }
+        T top() const { return this->_heap.top() ; }
+        bool empty() const { return this->_heap.empty() ; }
+        size_t size() const { return this->_heap.size() ; }
+        void update(size_t index, const T& value) { this->_heap.change_priority(index, value) ; }
+        void cancel(size_t index) { this->_heap.remove(index) ; }
+    private:
+        weak_heap<T> _heap ;
+} ;
+
+/*!
+ * \brief Adapts adaptive_heap to the interface used by the workloads.
+ */
+template<class T>
+class adaptive_heap_adapter
+{
+    public:
+        static constexpr bool indexed = true ;
+        static const char* name() { return "adaptive_heap" ; }
+        adaptive_heap_adapter(size_t capacity) : _heap(capacity) {}
+        void push(const T& value) { this->_heap.insert(value) ; }
+        T pop() { return this->_heap.extract_top() ; }
+        T top() const { return this->_heap.top() ; }
+        bool empty() const { return this->_heap.empty() ; }
+        size_t size() const { return this->_heap.size() ; }
+        void update(size_t index, const T& value) { this->_heap.change_priority(index, value) ; }
+        void cancel(size_t index) { this->_heap.remove(index) ; }
+    private:
+        adaptive_heap<T> _heap ;
+} ;
+
+/*!
+ * \brief Adapts std::priority_queue to the interface used by the
+ * workloads. It does not support updates and cancellations.
+ */
+template<class T>
+class priority_queue_adapter
+{
+    public:
+        static constexpr bool indexed = false ;
+        static const char* name() { return "std::pq" ; }
+        priority_queue_adapter(size_t) {}
+        void push(const T& value) { this->_heap.push(value) ; }
+        T pop() { T top = this->_heap.top() ; this->_heap.pop() ; return top ; }
+        T top() const { return this->_heap.top() ; }
+        bool empty() const { return this->_heap.empty() ; }
+        size_t size() const { return this->_heap.size() ; }
+        void update(size_t, const T&) {}
+        void cancel(size_t) {}
+    private:
+        std::priority_queue<T> _heap ;
+} ;
+
+
+/*!
+ * \brief A timer which does nothing, used for the throughput runs.
+ */
+struct null_timer
+{	void start() {}
+    void stop() {}
+} ;
+
+/*!
+ * \brief A timer timing one operation out of stride.
+ */
+class sampling_timer
+{
+    public:
+        sampling_timer(size_t stride) : _stride(stride), _count(0), _active(false) {}
+
+        void start()
+        {	if(++this->_count % this->_stride == 0)
+            {	this->_active = true ;
+                this->_watch.restart() ;
+            }
+        }
+
+        void stop()
+        {	if(this->_active)
+            {	this->_samples.push_back(this->_watch.elapsed_ns()) ;
+                this->_active = false ;
+            }
+        }
+
+        /*!
+         * \brief Returns the given percentile of the samples.
+         * \param p the percentile, in [0,1].
+         * \return the percentile, in nanoseconds.
+         */
+        double percentile(double p)
+        {	if(this->_samples.empty())
+            {	return 0. ; }
+            size_t i = std::min(this->_samples.size() - 1, static_cast<size_t>(p * this->_samples.size())) ;
+            std::nth_element(this->_samples.begin(), this->_samples.begin() + i, this->_samples.end()) ;
+            return this->_samples[i] ;
+        }
+
+    private:
+        size_t _stride ;
+        size_t _count ;
+        bool _active ;
+        stopwatch _watch ;
+        std::vector<double> _samples ;
+} ;
+
+
+/*!
+ * \brief The parameters of a workload run.
+ */
+template<class T>
+struct workload_input
+{	size_t n ;
+    const std::vector<T>* keys ;
+    /*!
+     * \brief The heap operations of the dijkstra workload : the rank of
+     * the inserted key, or -1 for an extraction.
+     */
+    const std::vector<int>* trace = nullptr ;
+} ;
+
+/*!
+ * \brief Runs Dijkstra with lazy deletion from node 0 of a random graph of n
+ * nodes, each node having an edge to the next node and to a random one, and
+ * returns the heap operations, the inserted distances being given by their
+ * rank in decreasing order (the largest key being the shortest distance).
+ * \param n the number of nodes.
+ * \param distances the number of distinct inserted distances.
+ * \return the heap operations.
+ */
+std::vector<int> dijkstra_trace(size_t n, size_t& distances)
+{	std::mt19937_64 generator(2) ;
+    std::vector<std::array<std::pair<size_t,std::int64_t>, 2>> edges(n) ;
+    for(size_t i=0; i<n; i++)
+    {	edges[i][0] = std::make_pair((i + 1) % n, static_cast<std::int64_t>(generator() % 1000 + 1)) ;
+        edges[i][1] = std::make_pair(generator() % n, static_cast<std::int64_t>(generator() % 1000 + 1)) ;
+    }
+
+    // the trace first holds the inserted distances
+    std::vector<std::int64_t> steps ;
+    std::vector<std::int64_t> distance(n, std::numeric_limits<std::int64_t>::max()) ;
+    std::vector<bool> settled(n, false) ;
+    typedef std::pair<std::int64_t,size_t> entry ;
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> queue ;
+    distance[0] = 0 ;
+    queue.push(entry(0, 0)) ;
+    steps.push_back(0) ;
+    while(not queue.empty())
+    {	entry top = queue.top() ;
+        queue.pop() ;
+        steps.push_back(-1) ;
+        // a stale entry, the node was settled at a shorter distance
+        if(settled[top.second])
+        {	continue ; }
+        settled[top.second] = true ;
+        for(const auto& edge : edges[top.second])
+        {	std::int64_t d = top.first + edge.second ;
+            if(d < distance[edge.first])
+            {	distance[edge.first] = d ;
+                queue.push(entry(d, edge.first)) ;
+                steps.push_back(d) ;
+            }
+        }
+    }
+
+    // then the ranks of the distances
+    std::vector<std::int64_t> sorted ;
+    for(std::int64_t step : steps)
+    {	if(step >= 0)
+        {	sorted.push_back(step) ; }
+    }
+    std::sort(sorted.begin(), sorted.end()) ;
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end()) ;
+    std::vector<int> trace ;
+    trace.reserve(steps.size()) ;
+    for(std::int64_t step : steps)
+    {	trace.push_back(step < 0 ? -1 : static_cast<int>(std::lower_bound(sorted.begin(), sorted.end(), step) - sorted.begin())) ; }
+    distances = sorted.size() ;
+    return trace ;
+}
+
+/*!
+ * \brief Fills a heap with the first n keys.
+ */
+template<class Heap, class T>
+void fill(Heap& heap, const workload_input<T>& in)
+{	for(size_t i=0; i<in.n; i++)
+    {	heap.push((*in.keys)[i]) ; }
+}
+
+template<class Heap, class T, class Timer>
+size_t hold(Heap& heap, const workload_input<T>& in, Timer& timer)
+{	std::mt19937_64 generator(1) ;
+    fill(heap, in) ;
+    size_t operations = std::max<size_t>(in.n, 100000) ;
+    for(size_t i=0; i<operations; i++)
+    {	timer.start() ;
+        T top = heap.pop() ;
+        timer.stop() ;
+        T next = lower_key(top, generator) ;
+        timer.start() ;
+        heap.push(next) ;
+        timer.stop() ;
+    }
+    return 2*operations ;
+}
+
+template<class Heap, class T, class Timer>
+size_t drain(Heap& heap, const workload_input<T>& in, Timer& timer)
+{	for(size_t i=0; i<in.n; i++)
+    {	timer.start() ;
+        heap.push((*in.keys)[i]) ;
+        timer.stop() ;
+    }
+    while(not heap.empty())
+    {	timer.start() ;
+        do_not_optimize(heap.pop()) ;
+        timer.stop() ;
+    }
+    return 2*in.n ;
+}
+
+template<class Heap, class T, class Timer>
+size_t dijkstra(Heap& heap, const workload_input<T>& in, Timer& timer)
+{	// the stale extractions, skipped by Dijkstra, still cost
+    // an extraction and are counted as operations
+    for(int step : *in.trace)
+    {	if(step >= 0)
+        {	const T& value = (*in.keys)[step] ;
+            timer.start() ;
+            heap.push(value) ;
+            timer.stop() ;
+        }
+        else
+        {	timer.start() ;
+            do_not_optimize(heap.pop()) ;
+            timer.stop() ;
+        }
+    }
+    return in.trace->size() ;
+}
+
+template<class Heap, class T, class Timer>
+size_t topk(Heap& heap, const workload_input<T>& in, Timer& timer)
+{	fill(heap, in) ;
+    size_t operations = 0 ;
+    for(size_t i=in.n; i<in.keys->size(); i++)
+    {	const T& value = (*in.keys)[i] ;
+        if(value < heap.top())
+        {	timer.start() ;
+            heap.pop() ;
+            timer.stop() ;
+            timer.start() ;
+            heap.push(value) ;
+            timer.stop() ;
+            operations += 2 ;
+        }
+    }
+    return operations ;
+}
+
+template<class Heap, class T, class Timer>
+size_t mixed(Heap& heap, const workload_input<T>& in, Timer& timer)
+{	std::mt19937_64 generator(3) ;
+    fill(heap, in) ;
+    size_t operations = std::max<size_t>(in.n, 100000) ;
+    for(size_t i=0; i<operations; i++)
+    {	size_t index = generator() % heap.size() ;
+        T value = random_key<T>(generator) ;
+        switch(generator() % 4)
+        {	case 0 :
+            case 1 :
+                timer.start() ;
+                heap.update(index, value) ;
+                timer.stop() ;
+                break ;
+            case 2 :
+                timer.start() ;
+                heap.cancel(index) ;
+                timer.stop() ;
+                heap.push(value) ;
+                break ;
+            default :
+                timer.start() ;
+                heap.pop() ;
+                timer.stop() ;
+                heap.push(value) ;
+                break ;
+        }
+    }
+    return operations ;
+}
+
+
+/*!
+ * \brief The names of the workloads.
+ */
+const char* workloads[] = {"hold", "drain", "dijkstra", "topk", "mixed"} ;
+
+template<class Heap, class T, class Timer>
+size_t run(size_t workload, Heap& heap, const workload_input<T>& in, Timer& timer)
+{	switch(workload)
+    {	case 0 : return hold(heap, in, timer) ;
+        case 1 : return drain(heap, in, timer) ;
+        case 2 : return dijkstra(heap, in, timer) ;
+        case 3 : return topk(heap, in, timer) ;
+        default : return mixed(heap, in, timer) ;
+    }
+}
+
+/*!
+ * \brief Returns the hardware counters shared by the runs.
+ */
+perf_counters& hardware_counters()
+{	static perf_counters counters ;
+    return counters ;
+}
+
+/*!
+ * \brief Prints hardware events divided by a number of operations.
+ */
+void print_events(const perf_values& events, double operations)
+{	std::cout << std::setw(10) << events.l1d_misses / operations << std::setw(10) << events.llc_misses / operations
+              << std::setw(10) << events.dtlb_misses / operations << std::setw(10) << events.branch_misses / operations ;
+}
+
+
+template<template<class...> class Adapter, class T>
+void benchmark(size_t workload, const workload_input<T>& in)
+{	typedef Adapter<T> heap_type ;
+    if((workload == 4) and not heap_type::indexed)
+    {	return ; }
+    size_t capacity = 3*in.n + 16 ;
+
+    // throughput
+    null_timer no_timer ;
+    heap_type heap(capacity) ;
+    perf_counters& counters = hardware_counters() ;
+    counters.reset() ;
+    counters.start() ;
+    stopwatch watch ;
+    size_t operations = run(workload, heap, in, no_timer) ;
+    double elapsed = watch.elapsed_ns() ;
+    counters.stop() ;
+
+    // latencies, on about 10^5 operations
+    sampling_timer timer(std::max<size_t>(1, operations / 100000)) ;
+    heap_type timed_heap(capacity) ;
+    run(workload, timed_heap, in, timer) ;
+
+    std::cout << std::setw(10) << workloads[workload] << std::setw(15) << heap_type::name()
+              << std::setw(10) << key_name<T>() << std::setw(12) << in.n << std::setw(12) << operations
+              << std::setw(10) << operations / elapsed * 1000. << std::setw(10) << elapsed / operations
+              << std::setw(10) << timer.percentile(0.5) << std::setw(10) << timer.percentile(0.99)
+              << std::setw(10) << timer.percentile(0.999) ;
+    if(counters.available())
+    {	print_events(counters.read(), operations) ; }
+    std::cout << std::endl ;
+}
+
+template<class T>
+void benchmark(size_t workload, size_t max_size)
+{	for(size_t n=10; n<=max_size; n*=10)
+    {	// the top-k stream is 10 times larger than the heap
+        std::vector<T> keys = random_keys<T>(workload == 3 ? 10*n : n) ;
+        workload_input<T> in{n, &keys} ;
+        // the dijkstra keys are the distances of the trace, in
+        // decreasing order for the maximum heaps
+        std::vector<int> trace ;
+        if(workload == 2)
+        {	size_t distances = 0 ;
+            trace = dijkstra_trace(n, distances) ;
+            keys = random_keys<T>(distances) ;
+            std::sort(keys.begin(), keys.end(), std::greater<T>()) ;
+            in.trace = &trace ;
+        }
+        benchmark<binary_heap_adapter>(workload, in) ;
+        benchmark<weak_heap_adapter>(workload, in) ;
+        benchmark<adaptive_heap_adapter>(workload, in) ;
+        benchmark<priority_queue_adapter>(workload, in) ;
+    }
+}
+
+/*!
+ * \brief Prints the latency histograms of binary_heap per operation,
+ * on a workload of size n with int keys.
+ */
+void histograms(size_t workload, size_t n)
+{	typedef binary_heap_adapter<int, latency_instrumentation<>> heap_type ;
+    std::vector<int> keys = random_keys<int>(n) ;
+    workload_input<int> in{n, &keys} ;
+    null_timer no_timer ;
+
+    binary_heap_adapter<int> plain_heap(3*n + 16) ;
+    stopwatch watch ;
+    run(workload, plain_heap, in, no_timer) ;
+    double plain = watch.elapsed_ns() ;
+    binary_heap_adapter<int, latency_instrumentation<64>> sampled_heap(3*n + 16) ;
+    watch.restart() ;
+    run(workload, sampled_heap, in, no_timer) ;
+    double sampled = watch.elapsed_ns() ;
+    heap_type heap(3*n + 16) ;
+    watch.restart() ;
+    run(workload, heap, in, no_timer) ;
+    double instrumented = watch.elapsed_ns() ;
+
+    // the overhead per heap operation, the fill included
+    double operations = heap.instrumentation().counters().operations ;
+    std::cout << std::endl << workloads[workload] << ", n = " << n << ", overhead "
+              << (instrumented - plain) / operations << " ns/op, sampled 1/64 "
+              << (sampled - plain) / operations << " ns/op" << std::endl ;
+    const char* names[] = {"build_heap", "insert", "extract_top", "remove", "change_priority"} ;
+    double ticks = latency_clock::ticks_per_ns() ;
+    for(size_t op=0; op<5; op++)
+    {	const auto& h = heap.instrumentation().histogram(static_cast<heap_operation>(op)) ;
+        if(h.count() == 0)
+        {	continue ; }
+        std::cout << std::setw(16) << names[op] << std::setw(12) << h.count()
+                  << std::setw(10) << h.percentile(0.5) / ticks << std::setw(10) << h.percentile(0.99) / ticks
+                  << std::setw(10) << h.percentile(0.999) / ticks << std::setw(12) << h.max() / ticks << std::endl ;
+    }
+}
+
+/*!
+ * \brief Prints the hardware events of binary_heap per operation kind,
+ * on a workload of size n with int keys.
+ */
+void events(size_t workload, size_t n)
+{	std::vector<int> keys = random_keys<int>(n) ;
+    workload_input<int> in{n, &keys} ;
+    null_timer no_timer ;
+    binary_heap_adapter<int, perf_instrumentation> heap(3*n + 16) ;
+    run(workload, heap, in, no_timer) ;
+
+    std::cout << std::endl << workloads[workload] << ", n = " << n << std::endl ;
+    const char* names[] = {"build_heap", "insert", "extract_top", "remove", "change_priority"} ;
+    for(size_t op=0; op<5; op++)
+    {	heap_operation operation = static_cast<heap_operation>(op) ;
+        size_t count = heap.instrumentation().operations(operation) ;
+        if(count == 0)
+        {	continue ; }
+        std::cout << std::setw(16) << names[op] << std::setw(12) << count ;
+        print_events(heap.instrumentation().events(operation), count) ;
+        std::cout << std::endl ;
+    }
+}
+
+
+int main(int argc, char** argv)
+{	size_t max_size = max_size_argument(argc, argv, 1000000) ;
+    std::string only = argc > 2 ? argv[2] : "" ;
+
+    std::cout << std::fixed << std::setprecision(1)
+              << std::setw(10) << "workload" << std::setw(15) << "heap" << std::setw(10) << "key"
+              << std::setw(12) << "n" << std::setw(12) << "ops" << std::setw(10) << "Mops/s"
+              << std::setw(10) << "ns/op" << std::setw(10) << "p50" << std::setw(10) << "p99"
+              << std::setw(10) << "p99.9" ;
+    if(hardware_counters().available())
+    {	std::cout << std::setw(10) << "L1D" << std::setw(10) << "LLC" << std::setw(10) << "dTLB"
+                  << std::setw(10) << "br-miss" ;
+    }
+    else
+    {	std::cout << std::endl << "(hardware counters unavailable, skipped)" ; }
+    std::cout << std::endl ;
+    for(size_t workload=0; workload<5; workload++)
+    {	if((not only.empty()) and (only != workloads[workload]))
+        {	continue ; }
+        benchmark<int>(workload, max_size) ;
+        benchmark<double>(workload, max_size) ;
+        benchmark<std::pair<int,int>>(workload, max_size) ;
+        benchmark<record64>(workload, max_size) ;
+    }
+
+    std::cout << std::endl << "binary_heap latency histograms (ns)" << std::endl
+              << std::setw(16) << "operation" << std::setw(12) << "count" << std::setw(10) << "p50"
+              << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(12) << "max" << std::endl ;
+    histograms(0, max_size) ;
+    histograms(4, max_size) ;
+
+    if(hardware_counters().available())
+    {	std::cout << std::endl << "binary_heap hardware events per operation" << std::endl
+                  << std::setw(16) << "operation" << std::setw(12) << "count" << std::setw(10) << "L1D"
+                  << std::setw(10) << "LLC" << std::setw(10) << "dTLB" << std::setw(10) << "br-miss" << std::endl ;
+        events(0, max_size) ;
+        events(4, max_size) ;
+    }
+    return 0 ;
+}
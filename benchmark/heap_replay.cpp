@@ -0,0 +1,148 @@
+/*
+ * Replays a heap trace (heap_trace.hpp) against the heaps of the repository
+ * and reports the time and the counters of each.
+ * Usage :
+ *  - heap_replay <trace> : replays the trace against binary_heap and weak_heap,
+ *    reporting the time per operation, the comparisons and moves of
+ *    binary_heap (counting_instrumentation) and the hardware events when they
+ *    are available (perf_counters.hpp),
+ *  - heap_replay record <trace> [n] : records a synthetic trace of int keys,
+ *    a heap of size n (10^5 by default) receiving 10n mixed insertions,
+ *    extractions, cancellations and priority changes.
+ * The trace is loaded in memory before being replayed, each heap replaying
+ * it 3 times, the best time being kept.
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "weak_heap.hpp"
+#include "heap_trace.hpp"
+#include "perf_counters.hpp"
+
+#include <fstream>
+#include <string>
+
+
+/*!
+ * \brief Replays the operations 3 times against a heap type and prints the
+ * best time, along with the hardware events of the same run.
+ */
+template<class Heap, class T>
+void replay(const char* name, const std::vector<trace_event<T>>& events, size_t capacity)
+{	double best = 0. ;
+    size_t operations = 0 ;
+    perf_counters counters ;
+    perf_values best_events{} ;
+    for(int i=0; i<3; i++)
+    {	Heap heap(capacity) ;
+        counters.reset() ;
+        counters.start() ;
+        stopwatch watch ;
+        operations = replay_trace(events, heap) ;
+        double elapsed = watch.elapsed_ns() ;
+        counters.stop() ;
+        if((i == 0) or (elapsed < best))
+        {	best = elapsed ;
+            if(counters.available())
+            {	best_events = counters.read() ; }
+        }
+    }
+    std::cout << std::setw(14) << name << std::setw(12) << operations
+              << std::setw(12) << best / 1e6 << std::setw(10) << best / operations ;
+    if(counters.available())
+    {	std::cout << "  L1D " << best_events.l1d_misses / double(operations)
+                  << "  LLC " << best_events.llc_misses / double(operations)
+                  << "  dTLB " << best_events.dtlb_misses / double(operations)
+                  << "  br-miss " << best_events.branch_misses / double(operations) ;
+    }
+    std::cout << std::endl ;
+}
+
+/*!
+ * \brief Reads a trace of keys of type T and replays it.
+ */
+template<class T>
+void replay(std::istream& stream)
+{	trace_reader<T> reader(stream) ;
+    size_t capacity = reader.header().capacity ;
+    std::vector<trace_event<T>> events = read_trace(reader) ;
+    std::cout << events.size() << " operations, " << key_name<T>() << " keys, maximum size "
+              << capacity << std::endl ;
+
+    std::cout << std::fixed << std::setprecision(1)
+              << std::setw(14) << "heap" << std::setw(12) << "ops" << std::setw(12) << "ms"
+              << std::setw(10) << "ns/op" << std::endl ;
+    replay<binary_heap<T>>("binary_heap", events, capacity) ;
+    replay<weak_heap<T>>("weak_heap", events, capacity) ;
+
+    binary_heap<T, std::allocator<T>, counting_instrumentation> heap(capacity) ;
+    replay_trace(events, heap) ;
+    heap_counters c = heap.instrumentation().counters() ;
+    double operations = c.operations ;
+    std::cout << "binary_heap, per operation : " << c.comparisons / operations << " comparisons, "
+              << c.moves / operations << " moves, " << c.sift_levels / operations
+              << " levels, max depth " << c.max_depth << std::endl ;
+}
+
+/*!
+ * \brief Records a synthetic trace.
+ */
+void record(std::ostream& stream, size_t n)
+{	recording_heap<binary_heap<int>, int> heap(n, stream) ;
+    std::mt19937_64 generator(4) ;
+    for(size_t i=0; i<10*n; i++)
+    {	size_t choice = generator() % 8 ;
+        int key = random_key<int>(generator) ;
+        if(heap.empty() or ((choice < 4) and not heap.full()))
+        {	heap.insert(key) ; }
+        else if(choice < 6)
+        {	heap.extract_top() ; }
+        else if(choice < 7)
+        {	heap.remove(generator() % heap.size()) ; }
+        else
+        {	heap.change_priority(generator() % heap.size(), key) ; }
+    }
+}
+
+
+int main(int argc, char** argv)
+{	if(argc < 2)
+    {	std::cerr << "usage : heap_replay <trace> | heap_replay record <trace> [n]" << std::endl ;
+        return 1 ;
+    }
+    try
+    {	if(std::string(argv[1]) == "record")
+        {	if(argc < 3)
+            {	std::cerr << "usage : heap_replay record <trace> [n]" << std::endl ;
+                return 1 ;
+            }
+            std::ofstream stream(argv[2], std::ios::binary) ;
+            record(stream, argc > 3 ? std::stoul(argv[3]) : 100000) ;
+            return stream ? 0 : 1 ;
+        }
+
+        std::ifstream stream(argv[1], std::ios::binary) ;
+        if(not stream)
+        {	std::cerr << "cannot open " << argv[1] << std::endl ;
+            return 1 ;
+        }
+        // dispatch on the key type stored in the header
+        char tag = trace_header::read(stream).key_tag ;
+        stream.seekg(0) ;
+        switch(tag)
+        {	case 'i' : replay<int>(stream) ; break ;
+            case 'u' : replay<unsigned>(stream) ; break ;
+            case 'l' : replay<int64_t>(stream) ; break ;
+            case 'q' : replay<uint64_t>(stream) ; break ;
+            case 'f' : replay<float>(stream) ; break ;
+            case 'd' : replay<double>(stream) ; break ;
+            default :
+                std::cerr << "unsupported key type" << std::endl ;
+                return 1 ;
+        }
+    }
+    catch(const std::exception& e)
+    {	std::cerr << e.what() << std::endl ;
+        return 1 ;
+    }
+    return 0 ;
+}
@@ -0,0 +1,76 @@
+/*
+ * Compares heap_sort and heap_partial_sort (heap_algorithm.hpp) for
+ * several arities with the standard library sorts.
+ * Usage : heap_sort_benchmark [max size], the default being 10^7.
+ * The times are given in nanoseconds per element.
+ */
+#include "benchmark.hpp"
+#include "heap_algorithm.hpp"
+
+#include <algorithm>
+
+
+template<class T>
+void benchmark_sort(size_t n)
+{	std::vector<T> data = random_keys<T>(n) ;
+    size_t r = repetitions(n) ;
+
+    std::cout << std::setw(10) << key_name<T>() << std::setw(14) << n
+              << std::setw(14) << time_per_element(data, [](std::vector<T>& v) { std::sort(v.begin(), v.end()) ; }, r)
+              << std::setw(14) << time_per_element(data, [](std::vector<T>& v) { std::make_heap(v.begin(), v.end()) ; std::sort_heap(v.begin(), v.end()) ; }, r)
+              << std::setw(14) << time_per_element(data, [](std::vector<T>& v) { heap_sort<2>(v.begin(), v.end()) ; }, r)
+              << std::setw(14) << time_per_element(data, [](std::vector<T>& v) { heap_sort<4>(v.begin(), v.end()) ; }, r)
+              << std::setw(14) << time_per_element(data, [](std::vector<T>& v) { heap_sort<8>(v.begin(), v.end()) ; }, r)
+              << std::endl ;
+}
+
+template<class T>
+void benchmark_partial_sort(size_t n, size_t k)
+{	std::vector<T> data = random_keys<T>(n) ;
+    size_t r = repetitions(n) ;
+
+    std::cout << std::setw(10) << key_name<T>() << std::setw(14) << n << std::setw(14) << k
+              << std::setw(14) << time_per_element(data, [k](std::vector<T>& v) { std::partial_sort(v.begin(), v.begin()+k, v.end()) ; }, r)
+              << std::setw(14) << time_per_element(data, [k](std::vector<T>& v) { heap_partial_sort<2>(v.begin(), v.begin()+k, v.end()) ; }, r)
+              << std::setw(14) << time_per_element(data, [k](std::vector<T>& v) { heap_partial_sort<4>(v.begin(), v.begin()+k, v.end()) ; }, r)
+              << std::setw(14) << time_per_element(data, [k](std::vector<T>& v) { heap_partial_sort<8>(v.begin(), v.begin()+k, v.end()) ; }, r)
+              << std::endl ;
+}
+
+template<class T>
+void benchmark(size_t max_size)
+{	for(size_t n=1000; n<=max_size; n*=10)
+    {	benchmark_sort<T>(n) ; }
+}
+
+template<class T>
+void benchmark_partial(size_t max_size)
+{	for(size_t n=1000; n<=max_size; n*=10)
+    {	benchmark_partial_sort<T>(n, 10) ;
+        benchmark_partial_sort<T>(n, n/10) ;
+    }
+}
+
+
+int main(int argc, char** argv)
+{	size_t max_size = max_size_argument(argc, argv, 10000000) ;
+    std::cout << std::fixed << std::setprecision(2) ;
+
+    std::cout << "sort (ns/element)" << std::endl
+              << std::setw(10) << "key" << std::setw(14) << "n"
+              << std::setw(14) << "std::sort" << std::setw(14) << "sort_heap"
+              << std::setw(14) << "heap_sort<2>" << std::setw(14) << "heap_sort<4>" << std::setw(14) << "heap_sort<8>"
+              << std::endl ;
+    benchmark<int>(max_size) ;
+    benchmark<double>(max_size) ;
+    benchmark<record64>(max_size) ;
+
+    std::cout << std::endl << "partial sort (ns/element)" << std::endl
+              << std::setw(10) << "key" << std::setw(14) << "n" << std::setw(14) << "k"
+              << std::setw(14) << "std" << std::setw(14) << "heap<2>" << std::setw(14) << "heap<4>" << std::setw(14) << "heap<8>"
+              << std::endl ;
+    benchmark_partial<int>(max_size) ;
+    benchmark_partial<double>(max_size) ;
+    benchmark_partial<record64>(max_size) ;
+    return 0 ;
+}
@@ -0,0 +1,187 @@
+/*
+ * Compares indirect_heap, ordering the indices of 64 bytes records by an
+ * int32 key, with binary_heap<record64>, which moves the records, on n
+ * insertions followed by n extractions.
+ * Before the timings, indirect_heap is checked for int16_t and float keys
+ * against a std::set of (key code, index) pairs : the extracted indices and
+ * keys, remove() and change_priority() at the positions returned by find(),
+ * and the heap built from a vector, the program returning 1 if they
+ * disagree.
+ * Usage : indirect_heap_benchmark [max size], the default being 10^6.
+ * The times are given in nanoseconds per operation.
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "indirect_heap.hpp"
+
+#include <set>
+
+
+/*!
+ * \brief Draws a key among a few hundred values, such that the keys have
+ * duplicates.
+ */
+template<class K>
+K draw_key(std::mt19937_64& generator) ;
+
+template<>
+inline std::int16_t draw_key<std::int16_t>(std::mt19937_64& generator)
+{	return static_cast<std::int16_t>(static_cast<int>(generator() % 400) - 200) ; }
+
+template<>
+inline float draw_key<float>(std::mt19937_64& generator)
+{	return (static_cast<int>(generator() % 400) - 200) / 4.f ; }
+
+/*!
+ * \brief Checks that the top of an indirect heap is the largest pair of a
+ * reference : the largest key, the largest index among the equal keys.
+ * \return whether they agree.
+ */
+template<class K>
+bool same_top(const indirect_heap<K>& heap, const std::set<std::pair<std::uint64_t,size_t>>& reference)
+{	if(heap.empty() or reference.empty())
+    {	return heap.empty() and reference.empty() ; }
+    const auto& top = *reference.rbegin() ;
+    bool same = (heap.top() == top.second) and (key_encoding<K>::encode(heap.top_key()) == top.first) ;
+    if(not same)
+    {	std::cerr << "indirect_heap<" << key_name<K>() << "> top " << +heap.top_key() << ':' << heap.top()
+                  << ", index " << top.second << " expected" << std::endl ;
+    }
+    return same ;
+}
+
+/*!
+ * \brief Inserts elements, changes and removes elements found by index,
+ * interleaved with extractions, then drains the heap, checking it against
+ * a set of (key code, index) pairs.
+ * \return whether the checks passed.
+ */
+template<class K>
+bool check_indirect()
+{	const size_t n = 2000 ;
+    std::mt19937_64 generator(15) ;
+    indirect_heap<K> heap(n) ;
+    std::set<std::pair<std::uint64_t,size_t>> reference ;
+    std::vector<K> keys(n) ;
+    for(size_t i=0; i<n; i++)
+    {	keys[i] = draw_key<K>(generator) ;
+        heap.insert(keys[i], i) ;
+        reference.insert(std::make_pair(key_encoding<K>::encode(keys[i]), i)) ;
+    }
+    if(not same_top(heap, reference))
+    {	return false ; }
+
+    for(size_t step=0; step<3000; step++)
+    {	size_t i = generator() % n ;
+        int position = heap.find(i) ;
+        bool present = reference.count(std::make_pair(key_encoding<K>::encode(keys[i]), i)) > 0 ;
+        if((position >= 0) != present)
+        {	std::cerr << "find(" << i << ") returned " << position << std::endl ;
+            return false ;
+        }
+        switch(step % 3)
+        {	case 0 :
+                if(present)
+                {	heap.remove(position) ;
+                    reference.erase(std::make_pair(key_encoding<K>::encode(keys[i]), i)) ;
+                }
+                break ;
+            case 1 :
+                if(present)
+                {	reference.erase(std::make_pair(key_encoding<K>::encode(keys[i]), i)) ;
+                    keys[i] = draw_key<K>(generator) ;
+                    heap.change_priority(position, keys[i]) ;
+                    reference.insert(std::make_pair(key_encoding<K>::encode(keys[i]), i)) ;
+                }
+                else
+                {	heap.insert(keys[i], i) ;
+                    reference.insert(std::make_pair(key_encoding<K>::encode(keys[i]), i)) ;
+                }
+                break ;
+            default :
+                if(not heap.empty())
+                {	size_t top = heap.extract_top() ;
+                    reference.erase(std::make_pair(key_encoding<K>::encode(keys[top]), top)) ;
+                }
+                break ;
+        }
+        if((heap.size() != reference.size()) or not same_top(heap, reference))
+        {	return false ; }
+    }
+
+    while(not heap.empty())
+    {	heap.extract_top() ;
+        reference.erase(std::prev(reference.end())) ;
+        if(not same_top(heap, reference))
+        {	return false ; }
+    }
+
+    // the heap built from a vector of keys
+    indirect_heap<K> built(keys) ;
+    for(size_t i=0; i<n; i++)
+    {	reference.insert(std::make_pair(key_encoding<K>::encode(keys[i]), i)) ; }
+    while(not built.empty())
+    {	if(not same_top(built, reference))
+        {	return false ; }
+        built.extract_top() ;
+        reference.erase(std::prev(reference.end())) ;
+    }
+    return true ;
+}
+
+
+/*!
+ * \brief Inserts the indices of the records by key, then extracts them all.
+ * \param records the records.
+ * \return the number of operations.
+ */
+size_t indirect_drain(const std::vector<record64>& records)
+{	indirect_heap<std::int32_t> heap(records.size()) ;
+    for(size_t i=0; i<records.size(); i++)
+    {	heap.insert(static_cast<std::int32_t>(records[i].key >> 32), i) ; }
+    while(not heap.empty())
+    {	do_not_optimize(records[heap.extract_top()]) ; }
+    return 2*records.size() ;
+}
+
+/*!
+ * \brief Inserts the records, then extracts them all.
+ * \param records the records.
+ * \return the number of operations.
+ */
+size_t record_drain(const std::vector<record64>& records)
+{	binary_heap<record64> heap(records.size()) ;
+    for(const record64& r : records)
+    {	heap.insert(r) ; }
+    while(not heap.empty())
+    {	do_not_optimize(heap.extract_top()) ; }
+    return 2*records.size() ;
+}
+
+template<class F>
+void benchmark(const char* name, const std::vector<record64>& records, F drain)
+{	stopwatch watch ;
+    size_t operations = drain(records) ;
+    double elapsed = watch.elapsed_ns() ;
+    std::cout << std::setw(14) << name << std::setw(12) << records.size()
+              << std::setw(12) << elapsed / operations << std::endl ;
+}
+
+
+int main(int argc, char** argv)
+{	size_t max_size = max_size_argument(argc, argv, 1000000) ;
+
+    if(not (check_indirect<std::int16_t>() and check_indirect<float>()))
+    {	return 1 ; }
+    std::cout << "indirect_heap checked" << std::endl ;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(14) << "heap" << std::setw(12) << "n"
+              << std::setw(12) << "ns/op" << std::endl ;
+    for(size_t n=1000; n<=max_size; n*=10)
+    {	std::vector<record64> records = random_keys<record64>(n) ;
+        benchmark("binary_heap", records, record_drain) ;
+        benchmark("indirect_heap", records, indirect_drain) ;
+    }
+    return 0 ;
+}
@@ -0,0 +1,120 @@
+/*
+ * Compares the k-way merge of sorted sequences using a loser tree
+ * (loser_tree.hpp), a binary_heap and a std::priority_queue, for k = 2
+ * to 4096.
+ * Usage : merge_benchmark [total size], the default being 2^22.
+ * The times are given in nanoseconds per merged element.
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "loser_tree.hpp"
+
+#include <algorithm>
+#include <queue>
+
+
+/*!
+ * \brief A value of a sequence along with the index of its sequence,
+ * ordered such that the maximum binary heap yields the smallest value.
+ */
+struct merge_entry
+{	int value ;
+    size_t source ;
+} ;
+
+inline bool operator > (const merge_entry& a, const merge_entry& b)
+{	return a.value < b.value ; }
+inline bool operator < (const merge_entry& a, const merge_entry& b)
+{	return a.value > b.value ; }
+
+
+typedef std::vector<std::vector<int>> sequences ;
+typedef std::vector<int>::const_iterator sequence_iterator ;
+
+/*!
+ * \brief Merges the sequences with a loser tree.
+ */
+void merge_loser_tree(const sequences& in, std::vector<int>& out)
+{	std::vector<std::pair<sequence_iterator,sequence_iterator>> ranges ;
+    for(const auto& s : in)
+    {	ranges.emplace_back(s.begin(), s.end()) ; }
+    loser_tree_merge(ranges, out.begin()) ;
+}
+
+/*!
+ * \brief Merges the sequences with a heap, each output element costing
+ * an extraction and an insertion.
+ */
+template<class Heap>
+void merge_heap(const sequences& in, std::vector<int>& out, Heap& heap)
+{	std::vector<sequence_iterator> positions ;
+    for(size_t i=0; i<in.size(); i++)
+    {	positions.push_back(in[i].begin()) ;
+        if(positions[i] != in[i].end())
+        {	heap.push(merge_entry{*positions[i]++, i}) ; }
+    }
+    auto o = out.begin() ;
+    while(not heap.empty())
+    {	merge_entry e = heap.top() ;
+        heap.pop() ;
+        *o++ = e.value ;
+        if(positions[e.source] != in[e.source].end())
+        {	heap.push(merge_entry{*positions[e.source]++, e.source}) ; }
+    }
+}
+
+/*!
+ * \brief Adapts binary_heap to the std::priority_queue interface.
+ */
+struct binary_heap_adapter
+{	binary_heap<merge_entry> heap ;
+    binary_heap_adapter(size_t k) : heap(k) {}
+    void push(const merge_entry& e) { this->heap.insert(e) ; }
+    void pop() { this->heap.extract_top() ; }
+    merge_entry top() const { return this->heap.top() ; }
+    bool empty() const { return this->heap.empty() ; }
+} ;
+
+
+template<class F>
+double time_merge(const sequences& in, size_t total, F function)
+{	double best = std::numeric_limits<double>::max() ;
+    for(int i=0; i<3; i++)
+    {	std::vector<int> out(total) ;
+        stopwatch watch ;
+        function(in, out) ;
+        best = std::min(best, watch.elapsed_ns()) ;
+        do_not_optimize(out.data()) ;
+    }
+    return best / total ;
+}
+
+
+int main(int argc, char** argv)
+{	size_t total = max_size_argument(argc, argv, size_t(1) << 22) ;
+    std::vector<int> keys = random_keys<int>(total) ;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(8) << "k" << std::setw(14) << "loser_tree" << std::setw(14) << "binary_heap"
+              << std::setw(14) << "priority_q" << std::endl ;
+    for(size_t k=2; k<=4096; k*=2)
+    {	sequences in(k) ;
+        for(size_t i=0; i<total; i++)
+        {	in[i % k].push_back(keys[i]) ; }
+        for(auto& s : in)
+        {	std::sort(s.begin(), s.end()) ; }
+
+        double t_tree = time_merge(in, total, merge_loser_tree) ;
+        double t_heap = time_merge(in, total, [k](const sequences& s, std::vector<int>& out)
+                                              {	binary_heap_adapter heap(k) ;
+                                                  merge_heap(s, out, heap) ;
+                                              }) ;
+        double t_queue = time_merge(in, total, [](const sequences& s, std::vector<int>& out)
+                                               {	std::priority_queue<merge_entry> heap ;
+                                                   merge_heap(s, out, heap) ;
+                                               }) ;
+        std::cout << std::setw(8) << k << std::setw(14) << t_tree << std::setw(14) << t_heap
+                  << std::setw(14) << t_queue << std::endl ;
+    }
+    return 0 ;
+}
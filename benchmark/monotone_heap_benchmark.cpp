@@ -0,0 +1,147 @@
+/*
+ * Compares monotone_heap with binary_heap and radix_heap on the hold model of
+ * a monotone workload : each operation extracts the top and inserts a key
+ * slightly lower, a key being searched every n operations.
+ * Before the timings, monotone_heap is checked against a std::multiset :
+ * the extractions, the searches, which must not leave the radix heap, and
+ * remove() and change_priority() at the indices found, in both modes, the
+ * program returning 1 if they disagree.
+ * Usage : monotone_heap_benchmark [max size], the default being 10^6.
+ * The times are given in nanoseconds per operation.
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "radix_heap.hpp"
+#include "monotone_heap.hpp"
+
+#include <set>
+
+
+/*!
+ * \brief Returns a value of a multiset, at a random position.
+ */
+int random_element(const std::multiset<int>& set, std::mt19937_64& generator)
+{	auto it = set.begin() ;
+    std::advance(it, generator() % set.size()) ;
+    return *it ;
+}
+
+/*!
+ * \brief Runs a monotone hold model with searches on a monotone_heap and a
+ * std::multiset, then removes and changes values at the indices found, and
+ * drains both.
+ * \return whether the heap agrees with the multiset.
+ */
+bool check_monotone()
+{	std::mt19937_64 generator(7) ;
+    monotone_heap<int, 8> heap(1000) ;
+    std::multiset<int> reference ;
+    for(int key : random_keys<int>(500))
+    {	heap.insert(key) ;
+        reference.insert(key) ;
+    }
+
+    for(size_t i=0; i<20000; i++)
+    {	int top = heap.extract_top() ;
+        if(top != *reference.rbegin())
+        {	std::cerr << "extracted " << top << " instead of " << *reference.rbegin() << std::endl ;
+            return false ;
+        }
+        reference.erase(std::prev(reference.end())) ;
+        int key = top - static_cast<int>(generator() % 100) ;
+        heap.insert(key) ;
+        reference.insert(key) ;
+
+        if(i % 100 == 99)
+        {	bool monotone = heap.monotone() ;
+            int value = random_element(reference, generator) ;
+            if((heap.find(value) == -1) or (heap.find(top + 1) != -1) or (heap.monotone() != monotone))
+            {	std::cerr << "find(" << value << ") failed or left the radix heap" << std::endl ;
+                return false ;
+            }
+        }
+    }
+    if(not heap.monotone() or (heap.stats().to_heap != 0))
+    {	std::cerr << "the monotone workload left the radix heap " << heap.stats().to_heap << " times" << std::endl ;
+        return false ;
+    }
+
+    // the first update leaves the radix heap, the others work
+    // on the binary heap
+    for(size_t i=0; i<100; i++)
+    {	int value = random_element(reference, generator) ;
+        reference.erase(reference.find(value)) ;
+        if(i % 2 == 0)
+        {	heap.remove(heap.find(value)) ; }
+        else
+        {	int priority = static_cast<int>(generator() >> 33) ;
+            heap.change_priority(heap.find(value), priority) ;
+            reference.insert(priority) ;
+        }
+    }
+    while(not reference.empty())
+    {	if(heap.extract_top() != *reference.rbegin())
+        {	std::cerr << "out of order after remove and change_priority" << std::endl ;
+            return false ;
+        }
+        reference.erase(std::prev(reference.end())) ;
+    }
+    if(not heap.empty())
+    {	std::cerr << heap.size() << " values left" << std::endl ;
+        return false ;
+    }
+    std::cout << "monotone_heap checked" << std::endl ;
+    return true ;
+}
+
+
+/*!
+ * \brief Runs the monotone hold model with searches.
+ * \param heap the heap, initially empty.
+ * \param keys the initial keys.
+ * \return the number of operations.
+ */
+template<class Heap>
+size_t hold(Heap& heap, const std::vector<int>& keys)
+{	std::mt19937_64 generator(8) ;
+    for(int key : keys)
+    {	heap.insert(key) ; }
+    size_t operations = std::max<size_t>(keys.size(), 1000000) ;
+    for(size_t i=0; i<operations; i++)
+    {	int top = heap.extract_top() ;
+        heap.insert(top - static_cast<int>(generator() % 100)) ;
+        // a search costs O(n)
+        if(i % keys.size() == 0)
+        {	do_not_optimize(heap.find(top)) ; }
+    }
+    return 2*operations ;
+}
+
+template<class Heap>
+void benchmark(const char* name, const std::vector<int>& keys)
+{	Heap heap(keys.size()) ;
+    stopwatch watch ;
+    size_t operations = hold(heap, keys) ;
+    double elapsed = watch.elapsed_ns() ;
+    std::cout << std::setw(14) << name << std::setw(12) << keys.size()
+              << std::setw(12) << elapsed / operations << std::endl ;
+}
+
+
+int main(int argc, char** argv)
+{	size_t max_size = max_size_argument(argc, argv, 1000000) ;
+
+    if(not check_monotone())
+    {	return 1 ; }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(14) << "heap" << std::setw(12) << "n"
+              << std::setw(12) << "ns/op" << std::endl ;
+    for(size_t n=100; n<=max_size; n*=10)
+    {	std::vector<int> keys = random_keys<int>(n) ;
+        benchmark<binary_heap<int>>("binary_heap", keys) ;
+        benchmark<radix_heap<int>>("radix_heap", keys) ;
+        benchmark<monotone_heap<int>>("monotone_heap", keys) ;
+    }
+    return 0 ;
+}
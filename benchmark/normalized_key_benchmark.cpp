@@ -0,0 +1,285 @@
+/*
+ * Compares an ORDER BY a, b DESC, c DESC, d DESC, e, f DESC LIMIT k over n
+ * rows kept in a binary_heap of normalized keys, the encoding included, with
+ * the same query on a binary_heap of rows compared column by column.
+ * Before the timings, normalized_key::compare is checked against the column
+ * by column comparator on the first column alone, the first two columns and
+ * all the columns, such that the keys are shorter and longer than their
+ * prefix : on random pairs of rows, rows compared with a copy of themselves,
+ * and sorted rows, the columns having few distinct values, with the extreme
+ * integers, infinities, NaNs, and strings holding 0 and 0xff bytes which are
+ * prefixes of one another, the program returning 1 if they disagree.
+ * Usage : normalized_key_benchmark [max size], the default being 10^6.
+ * The times are given in nanoseconds per row.
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "heap_key.hpp"
+#include "normalized_key.hpp"
+
+#include <cmath>
+
+
+/*!
+ * \brief A row of a table, ordered by a, b DESC, c DESC, d DESC, e, f DESC.
+ */
+struct row
+{	std::string a ;
+    std::int32_t b ;
+    std::string c ;
+    double d ;
+    std::int64_t e ;
+    std::uint32_t f ;
+} ;
+
+/*!
+ * \brief The number of columns of the rows.
+ */
+const size_t all_columns = 6 ;
+
+template<class T>
+int three_way(T x, T y)
+{	return x < y ? -1 : (y < x ? 1 : 0) ; }
+
+/*!
+ * \brief Compares two strings as unsigned bytes.
+ */
+int three_way(const std::string& x, const std::string& y)
+{	const unsigned char* bx = reinterpret_cast<const unsigned char*>(x.data()) ;
+    const unsigned char* by = reinterpret_cast<const unsigned char*>(y.data()) ;
+    if(std::lexicographical_compare(bx, bx + x.size(), by, by + y.size()))
+    {	return -1 ; }
+    return std::lexicographical_compare(by, by + y.size(), bx, bx + x.size()) ? 1 : 0 ;
+}
+
+/*!
+ * \brief Compares two doubles, the NaNs coming after +infinity.
+ */
+int three_way_nan(double x, double y)
+{	if(std::isnan(x) or std::isnan(y))
+    {	return three_way(std::isnan(x), std::isnan(y)) ; }
+    return three_way(x, y) ;
+}
+
+/*!
+ * \brief Compares two rows column by column.
+ * \param columns the number of columns of the ORDER BY, from the first one.
+ * \return a negative value, 0 or a positive value if the first row comes
+ * before, with or after the second one.
+ */
+int compare_rows(const row& x, const row& y, size_t columns = all_columns)
+{	int c = 0 ;
+    for(size_t i=0; (i<columns) and (c == 0); i++)
+    {	switch(i)
+        {	case 0 : c = three_way(x.a, y.a) ; break ;
+            case 1 : c = -three_way(x.b, y.b) ; break ;
+            case 2 : c = -three_way(x.c, y.c) ; break ;
+            case 3 : c = -three_way_nan(x.d, y.d) ; break ;
+            case 4 : c = three_way(x.e, y.e) ; break ;
+            default : c = -three_way(x.f, y.f) ; break ;
+        }
+    }
+    return c ;
+}
+
+/*!
+ * \brief Encodes the columns of a row.
+ * \param columns the number of columns of the ORDER BY, from the first one.
+ */
+normalized_key encode(normalized_key_encoder& encoder, const row& r, size_t columns = all_columns)
+{	for(size_t i=0; i<columns; i++)
+    {	switch(i)
+        {	case 0 : encoder.add(r.a) ; break ;
+            case 1 : encoder.add(r.b, column_order::descending) ; break ;
+            case 2 : encoder.add(r.c, column_order::descending) ; break ;
+            case 3 : encoder.add(r.d, column_order::descending) ; break ;
+            case 4 : encoder.add(r.e) ; break ;
+            default : encoder.add(r.f, column_order::descending) ; break ;
+        }
+    }
+    return encoder.finish() ;
+}
+
+/*!
+ * \brief Draws a string of 0 to 4 bytes among 0, 1, 'a', 'b' and 0xff.
+ */
+std::string random_string(std::mt19937_64& generator)
+{	const char bytes[] = {'\0', '\x01', 'a', 'b', '\xff'} ;
+    std::string s ;
+    size_t length = generator() % 5 ;
+    for(size_t i=0; i<length; i++)
+    {	s.push_back(bytes[generator() % 5]) ; }
+    return s ;
+}
+
+/*!
+ * \brief Draws rows which columns have few distinct values, such that the
+ * rows tie on their first columns.
+ * \param n the number of rows.
+ * \param seed the seed of the random generator.
+ * \return the rows.
+ */
+std::vector<row> random_rows(size_t n, std::uint64_t seed)
+{	const std::int32_t bs[] = {std::numeric_limits<std::int32_t>::min(), -1, 0, 1, 256, std::numeric_limits<std::int32_t>::max()} ;
+    const double ds[] = {-std::numeric_limits<double>::infinity(), -2.5, 0., 1e-300, 1e300,
+                         std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()} ;
+    const std::int64_t es[] = {std::numeric_limits<std::int64_t>::min(), -1, 0, 1, std::numeric_limits<std::int64_t>::max()} ;
+    const std::uint32_t fs[] = {0, 1, 0x80000000u, std::numeric_limits<std::uint32_t>::max()} ;
+    std::mt19937_64 generator(seed) ;
+    std::vector<row> rows(n) ;
+    for(row& r : rows)
+    {	r.a = random_string(generator) ;
+        r.b = bs[generator() % 6] ;
+        r.c = random_string(generator) ;
+        r.d = ds[generator() % 7] ;
+        r.e = es[generator() % 5] ;
+        r.f = fs[generator() % 4] ;
+    }
+    return rows ;
+}
+
+/*!
+ * \brief Checks that two keys compare as their rows.
+ * \return whether they agree.
+ */
+bool same_order(const normalized_key& kx, const normalized_key& ky, const row& x, const row& y, size_t columns)
+{	int expected = compare_rows(x, y, columns) ;
+    int c = kx.compare(ky) ;
+    bool same = (three_way(c, 0) == three_way(expected, 0)) and (three_way(ky.compare(kx), 0) == -three_way(expected, 0))
+                and ((kx < ky) == (expected < 0)) and ((kx == ky) == (expected == 0)) ;
+    if(not same)
+    {	std::cerr << "keys " << kx << "and " << ky << "compare to " << c << ", " << expected << " expected" << std::endl ;
+    }
+    return same ;
+}
+
+/*!
+ * \brief Compares normalized keys with the column by column comparator on
+ * random pairs, equal rows and sorted rows, the arena having small blocks.
+ * \param columns the number of columns of the ORDER BY, from the first one.
+ * \return whether the orders agree.
+ */
+bool check_compare(size_t columns)
+{	std::vector<row> rows = random_rows(20000, 17) ;
+    // rows longer than a block of the arena
+    rows[0].a = std::string(100, 'a') ;
+    rows[1].a = std::string(99, 'a') + '\0' ;
+    normalized_key_encoder encoder(64) ;
+    std::vector<normalized_key> keys ;
+    for(const row& r : rows)
+    {	keys.push_back(encode(encoder, r, columns)) ; }
+
+    std::mt19937_64 generator(18) ;
+    for(size_t i=0; i<200000; i++)
+    {	size_t x = generator() % rows.size() ;
+        size_t y = generator() % rows.size() ;
+        if(not same_order(keys[x], keys[y], rows[x], rows[y], columns))
+        {	return false ; }
+    }
+
+    // the rows compared with themselves, encoded again
+    for(size_t i=0; i<rows.size(); i++)
+    {	normalized_key copy = encode(encoder, rows[i], columns) ;
+        if(not same_order(keys[i], copy, rows[i], rows[i], columns))
+        {	return false ; }
+    }
+
+    // the sorted keys are the sorted rows, neighbours comparing
+    // as the rows
+    std::vector<size_t> order(rows.size()) ;
+    for(size_t i=0; i<order.size(); i++)
+    {	order[i] = i ; }
+    std::sort(order.begin(), order.end(), [&keys](size_t x, size_t y) { return keys[x] < keys[y] ; }) ;
+    for(size_t i=1; i<order.size(); i++)
+    {	size_t x = order[i-1] ;
+        size_t y = order[i] ;
+        if((compare_rows(rows[x], rows[y], columns) > 0) or not same_order(keys[x], keys[y], rows[x], rows[y], columns))
+        {	std::cerr << "the sorted keys are not sorted rows on " << columns << " columns" << std::endl ;
+            return false ;
+        }
+    }
+    return true ;
+}
+
+
+/*!
+ * \brief A row compared column by column in a heap.
+ */
+struct ranked_row
+{	const row* r ;
+} ;
+
+inline bool operator < (const ranked_row& x, const ranked_row& y)
+{	return compare_rows(*x.r, *y.r) < 0 ; }
+inline bool operator > (const ranked_row& x, const ranked_row& y)
+{	return compare_rows(*x.r, *y.r) > 0 ; }
+
+/*!
+ * \brief Keeps the k first rows in a heap of rows.
+ * \return the index of the last row kept.
+ */
+size_t row_limit(const std::vector<row>& rows, size_t k)
+{	binary_heap<ranked_row> heap(k) ;
+    for(const row& r : rows)
+    {	if(not heap.full())
+        {	heap.insert({&r}) ; }
+        else if(ranked_row{&r} < heap.top())
+        {	heap.extract_top() ;
+            heap.insert({&r}) ;
+        }
+    }
+    return static_cast<size_t>(heap.top().r - rows.data()) ;
+}
+
+/*!
+ * \brief Keeps the k first rows in a heap of normalized keys, encoding each
+ * row.
+ * \return the index of the last row kept.
+ */
+size_t key_limit(const std::vector<row>& rows, size_t k)
+{	typedef std::pair<normalized_key, size_t> entry ;
+    normalized_key_encoder encoder ;
+    binary_heap<entry, std::allocator<entry>, null_instrumentation, first_key> heap(k) ;
+    for(size_t i=0; i<rows.size(); i++)
+    {	normalized_key key = encode(encoder, rows[i]) ;
+        if(not heap.full())
+        {	heap.insert({key, i}) ; }
+        else if(key < heap.top().first)
+        {	heap.extract_top() ;
+            heap.insert({key, i}) ;
+        }
+    }
+    return heap.top().second ;
+}
+
+template<class F>
+void benchmark(const char* name, const std::vector<row>& rows, size_t k, F limit)
+{	stopwatch watch ;
+    do_not_optimize(limit(rows, k)) ;
+    double elapsed = watch.elapsed_ns() ;
+    std::cout << std::setw(16) << name << std::setw(12) << rows.size() << std::setw(8) << k
+              << std::setw(12) << elapsed / rows.size() << std::endl ;
+}
+
+
+int main(int argc, char** argv)
+{	size_t max_size = max_size_argument(argc, argv, 1000000) ;
+
+    if(not (check_compare(1) and check_compare(2) and check_compare(all_columns)))
+    {	return 1 ; }
+    std::cout << "normalized_key checked" << std::endl ;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(16) << "heap" << std::setw(12) << "n" << std::setw(8) << "k"
+              << std::setw(12) << "ns/row" << std::endl ;
+    for(size_t n=1000; n<=max_size; n*=10)
+    {	std::vector<row> rows = random_rows(n, 19) ;
+        for(size_t k : {10, 1000})
+        {	if(k <= n)
+            {	benchmark("rows", rows, k, row_limit) ;
+                benchmark("normalized_key", rows, k, key_limit) ;
+            }
+        }
+    }
+    return 0 ;
+}
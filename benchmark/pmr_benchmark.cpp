@@ -0,0 +1,117 @@
+/*
+ * Compares short lived binary heaps allocated with std::allocator with
+ * pmr::binary_heap carved from a std::pmr::monotonic_buffer_resource over a
+ * stack buffer, released in bulk : each round builds a heap of n values,
+ * drains it and drops it.
+ * Before the timings, counting_resource is installed as the default resource
+ * and as the upstream of the arena, and the program returns 1 if a round of
+ * pmr heaps allocates from either.
+ * Usage : pmr_benchmark [max size], the default being 10^4.
+ * The times are given in nanoseconds per operation.
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "counting_resource.hpp"
+
+#include <memory_resource>
+
+
+/*!
+ * \brief The size of the arena buffer, in bytes.
+ */
+constexpr size_t arena_size = 1 << 20 ;
+
+/*!
+ * \brief Builds a heap of the given keys in an arena over a buffer, drains
+ * it, and releases the arena.
+ * \param keys the keys.
+ * \param buffer the buffer of the arena, of arena_size bytes.
+ * \param upstream the upstream resource of the arena.
+ * \return the sum of the extracted keys.
+ */
+long long arena_round(const std::vector<int>& keys, unsigned char* buffer, std::pmr::memory_resource* upstream)
+{	std::pmr::monotonic_buffer_resource arena(buffer, arena_size, upstream) ;
+    pmr::binary_heap<int> heap(keys.size(), &arena) ;
+    for(int key : keys)
+    {	heap.insert(key) ; }
+    long long sum = 0 ;
+    while(not heap.empty())
+    {	sum += heap.extract_top() ; }
+    return sum ;
+}
+
+/*!
+ * \brief The same round with a heap allocated by std::allocator.
+ */
+long long allocator_round(const std::vector<int>& keys)
+{	binary_heap<int> heap(keys.size()) ;
+    for(int key : keys)
+    {	heap.insert(key) ; }
+    long long sum = 0 ;
+    while(not heap.empty())
+    {	sum += heap.extract_top() ; }
+    return sum ;
+}
+
+
+/*!
+ * \brief Runs arena rounds with counting_resource installed as the default
+ * resource and as the upstream of the arena, and checks that neither sees
+ * an allocation.
+ * \param buffer the buffer of the arena, of arena_size bytes.
+ * \return whether no allocation reached the counting resources.
+ */
+bool check_no_allocation(unsigned char* buffer)
+{	std::vector<int> keys = random_keys<int>(1000) ;
+    counting_resource global ;
+    counting_resource upstream ;
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(&global) ;
+    long long sum = 0 ;
+    for(int round=0; round<100; round++)
+    {	sum += arena_round(keys, buffer, &upstream) ; }
+    std::pmr::set_default_resource(previous) ;
+    do_not_optimize(sum) ;
+    if((global.allocations() != 0) or (upstream.allocations() != 0))
+    {	std::cerr << global.allocations() << " default and " << upstream.allocations()
+                  << " upstream allocations" << std::endl ;
+        return false ;
+    }
+    std::cout << "no allocation outside the arena" << std::endl ;
+    return true ;
+}
+
+
+int main(int argc, char** argv)
+{	size_t max_size = max_size_argument(argc, argv, 10000) ;
+    // the heap has to fit in the arena
+    max_size = std::min(max_size, arena_size / sizeof(int) / 2) ;
+    std::vector<unsigned char> buffer(arena_size) ;
+
+    if(not check_no_allocation(buffer.data()))
+    {	return 1 ; }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(14) << "storage" << std::setw(12) << "n"
+              << std::setw(12) << "ns/op" << std::endl ;
+    for(size_t n=10; n<=max_size; n*=10)
+    {	std::vector<int> keys = random_keys<int>(n) ;
+        size_t rounds = std::max<size_t>(1, 1000000 / n) ;
+
+        stopwatch watch ;
+        long long sum = 0 ;
+        for(size_t round=0; round<rounds; round++)
+        {	sum += allocator_round(keys) ; }
+        double elapsed = watch.elapsed_ns() ;
+        std::cout << std::setw(14) << "std::allocator" << std::setw(12) << n
+                  << std::setw(12) << elapsed / (2*n*rounds) << std::endl ;
+
+        watch.restart() ;
+        for(size_t round=0; round<rounds; round++)
+        {	sum += arena_round(keys, buffer.data(), std::pmr::null_memory_resource()) ; }
+        elapsed = watch.elapsed_ns() ;
+        std::cout << std::setw(14) << "arena" << std::setw(12) << n
+                  << std::setw(12) << elapsed / (2*n*rounds) << std::endl ;
+        do_not_optimize(sum) ;
+    }
+    return 0 ;
+}
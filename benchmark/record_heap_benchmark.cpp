@@ -0,0 +1,164 @@
+/*
+ * Compares record_heap, configured at run time for 64 bytes records with an
+ * int64 key, with binary_heap<record64>, which layout is known at compile
+ * time, on n insertions followed by n extractions.
+ * Before the timings, the records of every key type and of 8, 16, 24, 32 and
+ * 64 bytes (the key at the end of the record) are checked to come out by
+ * decreasing key with their bytes intact, the program returning 1 otherwise.
+ * Usage : record_heap_benchmark [max size], the default being 10^6.
+ * The times are given in nanoseconds per operation.
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "record_heap.hpp"
+
+#include <cstddef> // offsetof
+#include <type_traits>
+
+
+/*!
+ * \brief Returns a value in the order of the record_heap keys : the integer
+ * keys themselves, and the order-preserving codes of the floating point ones.
+ * \param key a key of interest.
+ * \return the value of the key.
+ */
+template<class Key>
+inline Key key_order(Key key)
+{	return key ; }
+
+inline std::uint32_t key_order(float key)
+{	return key_encoding<float>::encode(key) ; }
+
+inline std::uint64_t key_order(double key)
+{	return key_encoding<double>::encode(key) ; }
+
+
+/*!
+ * \brief Fills a record_heap of a given layout with random records, drains
+ * it and checks the order of the keys and the bytes of the records.
+ * \param key_type the type of the keys.
+ * \param record_size the size of the records.
+ * \return whether the records come out in order.
+ */
+template<class Key>
+bool check_layout(record_key key_type, size_t record_size)
+{	const size_t n = 1000 ;
+    const size_t key_offset = record_size - sizeof(Key) ;
+    std::mt19937_64 generator(6) ;
+    record_heap heap(n, record_size, key_offset, key_type) ;
+    std::vector<unsigned char> record(record_size) ;
+    std::uint64_t checksum = 0 ;
+    for(size_t i=0; i<n; i++)
+    {	for(unsigned char& byte : record)
+        {	byte = static_cast<unsigned char>(generator()) ; }
+        // the random bytes of a floating point key may be a NaN
+        double value = std::uniform_real_distribution<double>(std::is_signed<Key>::value ? -1e6 : 0., 1e6)(generator) ;
+        Key key = static_cast<Key>(value) ;
+        std::memcpy(record.data() + key_offset, &key, sizeof(key)) ;
+        for(unsigned char byte : record)
+        {	checksum += byte ; }
+        heap.insert(record.data()) ;
+    }
+
+    typedef decltype(key_order(Key())) order_type ;
+    order_type last = std::numeric_limits<order_type>::max() ;
+    while(not heap.empty())
+    {	heap.extract_top(record.data()) ;
+        Key key ;
+        std::memcpy(&key, record.data() + key_offset, sizeof(key)) ;
+        if(key_order(key) > last)
+        {	std::cerr << "record of " << record_size << " bytes out of order, key " << key << std::endl ;
+            return false ;
+        }
+        last = key_order(key) ;
+        for(unsigned char byte : record)
+        {	checksum -= byte ; }
+    }
+    if(checksum != 0)
+    {	std::cerr << "records of " << record_size << " bytes altered" << std::endl ;
+        return false ;
+    }
+    return true ;
+}
+
+/*!
+ * \brief Checks all the key types and the record sizes, which covers all
+ * the sift kernels.
+ * \return whether the records come out in order.
+ */
+bool check_layouts()
+{	const size_t sizes[] = {8, 16, 24, 32, 64} ;
+    for(size_t size : sizes)
+    {	if(not (check_layout<std::int32_t>(record_key::int32, size) and
+                check_layout<std::uint32_t>(record_key::uint32, size) and
+                check_layout<std::int64_t>(record_key::int64, size) and
+                check_layout<std::uint64_t>(record_key::uint64, size) and
+                check_layout<float>(record_key::float32, size) and
+                check_layout<double>(record_key::float64, size)))
+        {	return false ; }
+    }
+    std::cout << "record layouts checked" << std::endl ;
+    return true ;
+}
+
+
+/*!
+ * \brief Adapts binary_heap<record64> to the interface of record_heap.
+ */
+class record64_heap
+{
+    public:
+        record64_heap(size_t sizeMax) : _heap(sizeMax) {}
+        void insert(const void* record) { this->_heap.insert(*static_cast<const record64*>(record)) ; }
+        void extract_top(void* record) { *static_cast<record64*>(record) = this->_heap.extract_top() ; }
+        bool empty() const { return this->_heap.empty() ; }
+    private:
+        binary_heap<record64> _heap ;
+} ;
+
+/*!
+ * \brief Inserts the records, then extracts them all.
+ * \param heap the heap, initially empty.
+ * \param records the records.
+ * \return the number of operations.
+ */
+template<class Heap>
+size_t drain(Heap& heap, const std::vector<record64>& records)
+{	for(const record64& r : records)
+    {	heap.insert(&r) ; }
+    record64 top ;
+    while(not heap.empty())
+    {	heap.extract_top(&top) ;
+        do_not_optimize(top) ;
+    }
+    return 2*records.size() ;
+}
+
+template<class Heap>
+void benchmark(const char* name, Heap& heap, const std::vector<record64>& records)
+{	stopwatch watch ;
+    size_t operations = drain(heap, records) ;
+    double elapsed = watch.elapsed_ns() ;
+    std::cout << std::setw(14) << name << std::setw(12) << records.size()
+              << std::setw(12) << elapsed / operations << std::endl ;
+}
+
+
+int main(int argc, char** argv)
+{	size_t max_size = max_size_argument(argc, argv, 1000000) ;
+
+    if(not check_layouts())
+    {	return 1 ; }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(14) << "heap" << std::setw(12) << "n"
+              << std::setw(12) << "ns/op" << std::endl ;
+    for(size_t n=1000; n<=max_size; n*=10)
+    {	std::vector<record64> records = random_keys<record64>(n) ;
+        record_heap heap(n, sizeof(record64), offsetof(record64, key), record_key::int64) ;
+        benchmark("record_heap", heap, records) ;
+        record64_heap typed_heap(n) ;
+        benchmark("binary_heap", typed_heap, records) ;
+    }
+    return 0 ;
+}
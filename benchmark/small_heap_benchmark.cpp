@@ -0,0 +1,175 @@
+/*
+ * Compares the heaps storing their elements inline, static_binary_heap and
+ * small_binary_heap, with binary_heap on small sizes : each round fills a
+ * fresh heap with n values and drains it, as a heap local to a function
+ * would.
+ * The constexpr methods of static_binary_heap are checked at compile time.
+ * Before the timings, small_binary_heap is checked to allocate only when its
+ * N+1th element is inserted and to keep its order across the move, the
+ * program returning 1 otherwise.
+ * Usage : small_heap_benchmark
+ * The times are given in nanoseconds per operation.
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "static_binary_heap.hpp"
+#include "small_binary_heap.hpp"
+#include "counting_resource.hpp"
+
+#include <functional> // greater
+#include <memory_resource>
+
+
+/*!
+ * \brief Drains a static heap built from a list in a constant expression.
+ * \return the values in extraction order.
+ */
+constexpr std::array<int, 6> static_drain()
+{	static_binary_heap<int, 8> heap{5, 1, 9, 7, 3, 9} ;
+    std::array<int, 6> values{} ;
+    for(size_t i=0; i<values.size(); i++)
+    {	values[i] = heap.extract_top() ; }
+    return values ;
+}
+
+/*!
+ * \brief Removes and changes values of a static heap in a constant
+ * expression.
+ * \return the values in extraction order.
+ */
+constexpr std::array<int, 4> static_update()
+{	static_binary_heap<int, 5> heap{4, 8, 2, 6, 1} ;
+    heap.remove(heap.find(6)) ;
+    heap.change_priority(heap.find(2), 10) ;
+    heap.change_priority(heap.find(8), 0) ;
+    std::array<int, 4> values{} ;
+    for(size_t i=0; i<values.size(); i++)
+    {	values[i] = heap.extract_top() ; }
+    return values ;
+}
+
+/*!
+ * \brief Compares two arrays in a constant expression (the comparison
+ * operators of std::array are constexpr from C++20 only).
+ */
+template<size_t M>
+constexpr bool equal(const std::array<int, M>& a, const std::array<int, M>& b)
+{	for(size_t i=0; i<M; i++)
+    {	if(a[i] != b[i])
+        {	return false ; }
+    }
+    return true ;
+}
+
+static_assert(equal(static_drain(), {9, 9, 7, 5, 3, 1}), "static_binary_heap drain order") ;
+static_assert(equal(static_update(), {10, 4, 1, 0}), "static_binary_heap remove and change_priority") ;
+static_assert(static_binary_heap<int, 4>{1, 2, 3, 4}.full(), "static_binary_heap full") ;
+static_assert(static_binary_heap<int, 4>().find(1) == -1, "static_binary_heap find") ;
+
+
+/*!
+ * \brief Fills a small_binary_heap of inline capacity N, allocating from a
+ * counting resource, with 2N values and drains it. Checks that the heap
+ * stays inline without allocating up to N values, allocates on the N+1th
+ * and extracts the values in decreasing order.
+ * \return whether the checks passed.
+ */
+template<size_t N>
+bool check_spill()
+{	typedef small_binary_heap<int, N, std::pmr::polymorphic_allocator<int>> heap_type ;
+    std::vector<int> keys = random_keys<int>(2*N, N) ;
+    counting_resource resource ;
+    heap_type heap(2*N, &resource) ;
+    for(size_t i=0; i<keys.size(); i++)
+    {	heap.insert(keys[i]) ;
+        bool inlined = i < N ;
+        if((heap.inlined() != inlined) or ((resource.allocations() == 0) != inlined))
+        {	std::cerr << "small_binary_heap<int, " << N << "> of size " << heap.size() << (heap.inlined() ? " inlined" : " not inlined")
+                      << " after " << resource.allocations() << " allocations" << std::endl ;
+            return false ;
+        }
+    }
+
+    std::sort(keys.begin(), keys.end(), std::greater<int>()) ;
+    for(int key : keys)
+    {	if(heap.extract_top() != key)
+        {	std::cerr << "small_binary_heap<int, " << N << "> out of order" << std::endl ;
+            return false ;
+        }
+    }
+
+    // a heap built from at most N values stays inline
+    heap_type built(std::vector<int>(keys.begin(), keys.begin() + N), &resource) ;
+    if(not built.inlined() or (built.top() != keys[0]))
+    {	std::cerr << "small_binary_heap<int, " << N << "> built from " << N << " values not inlined" << std::endl ;
+        return false ;
+    }
+    return true ;
+}
+
+
+/*!
+ * \brief Fills a heap with the keys and drains it.
+ * \param keys the keys.
+ * \return the sum of the extracted keys.
+ */
+template<class Heap>
+long long round_trip(Heap& heap, const std::vector<int>& keys)
+{	for(int key : keys)
+    {	heap.insert(key) ; }
+    long long sum = 0 ;
+    while(not heap.empty())
+    {	sum += heap.extract_top() ; }
+    return sum ;
+}
+
+template<size_t N>
+void benchmark()
+{	std::vector<int> keys = random_keys<int>(N) ;
+    const size_t rounds = 1000000 / N ;
+    long long sum = 0 ;
+
+    stopwatch watch ;
+    for(size_t round=0; round<rounds; round++)
+    {	binary_heap<int> heap(N) ;
+        sum += round_trip(heap, keys) ;
+    }
+    double elapsed = watch.elapsed_ns() ;
+    std::cout << std::setw(20) << "binary_heap" << std::setw(8) << N
+              << std::setw(12) << elapsed / (2*N*rounds) << std::endl ;
+
+    watch.restart() ;
+    for(size_t round=0; round<rounds; round++)
+    {	static_binary_heap<int, N> heap ;
+        sum += round_trip(heap, keys) ;
+    }
+    elapsed = watch.elapsed_ns() ;
+    std::cout << std::setw(20) << "static_binary_heap" << std::setw(8) << N
+              << std::setw(12) << elapsed / (2*N*rounds) << std::endl ;
+
+    watch.restart() ;
+    for(size_t round=0; round<rounds; round++)
+    {	small_binary_heap<int, N> heap(N) ;
+        sum += round_trip(heap, keys) ;
+    }
+    elapsed = watch.elapsed_ns() ;
+    std::cout << std::setw(20) << "small_binary_heap" << std::setw(8) << N
+              << std::setw(12) << elapsed / (2*N*rounds) << std::endl ;
+    do_not_optimize(sum) ;
+}
+
+
+int main()
+{	if(not (check_spill<1>() and check_spill<4>() and check_spill<16>()))
+    {	return 1 ; }
+    std::cout << "small_binary_heap spill checked" << std::endl ;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(20) << "heap" << std::setw(8) << "n"
+              << std::setw(12) << "ns/op" << std::endl ;
+    benchmark<8>() ;
+    benchmark<16>() ;
+    benchmark<32>() ;
+    benchmark<64>() ;
+    return 0 ;
+}
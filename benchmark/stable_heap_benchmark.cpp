@@ -0,0 +1,118 @@
+/*
+ * Compares stable_binary_heap, with 64 and 32 bits insertion counters, with
+ * binary_heap (which does not keep the insertion order of equal values) on
+ * the hold model with 16 priorities, such that most comparisons are ties.
+ * Before the timings, the first in first out order of equal values is
+ * checked across many renumberings with an 8 bits counter, the program
+ * returning 1 if it is broken.
+ * Usage : stable_heap_benchmark [max size], the default being 10^6.
+ * The times are given in nanoseconds per operation.
+ */
+#include "benchmark.hpp"
+#include "binary_heap.hpp"
+#include "stable_binary_heap.hpp"
+
+
+/*!
+ * \brief A job of a given priority, numbered in its submission order.
+ */
+struct job
+{	int priority ;
+    std::uint32_t id ;
+} ;
+
+inline bool operator < (const job& a, const job& b)
+{	return a.priority < b.priority ; }
+inline bool operator > (const job& a, const job& b)
+{	return a.priority > b.priority ; }
+inline bool operator == (const job& a, const job& b)
+{	return (a.priority == b.priority) and (a.id == b.id) ; }
+
+inline std::ostream& operator << (std::ostream& stream, const job& j)
+{	return stream << j.priority << ':' << j.id ; }
+
+
+/*!
+ * \brief Runs the hold model with a stable heap of 8 bits counter, which is
+ * renumbered every 191 insertions, and checks that the jobs of each priority
+ * come out in their submission order.
+ * \return whether the order is kept.
+ */
+bool check_fifo_order()
+{	const size_t size = 64 ;
+    const size_t operations = 100000 ;
+    std::mt19937_64 generator(4) ;
+    stable_binary_heap<job, std::uint8_t> heap(size) ;
+    std::uint32_t id = 0 ;
+    for(size_t i=0; i<size; i++)
+    {	heap.insert(job{static_cast<int>(generator() % 4), id++}) ; }
+
+    // the last id extracted per priority, +1
+    std::vector<std::uint32_t> last(4, 0) ;
+    for(size_t i=0; i<operations; i++)
+    {	job top = heap.extract_top() ;
+        if(top.id + 1 <= last[top.priority])
+        {	std::cerr << "job " << top << " extracted after job " << top.priority << ':' << last[top.priority] - 1
+                      << " (" << heap.renumberings() << " renumberings)" << std::endl ;
+            return false ;
+        }
+        last[top.priority] = top.id + 1 ;
+        heap.insert(job{static_cast<int>(generator() % 4), id++}) ;
+    }
+    if(heap.renumberings() < operations / 256)
+    {	std::cerr << "only " << heap.renumberings() << " renumberings" << std::endl ;
+        return false ;
+    }
+    std::cout << "fifo order kept across " << heap.renumberings() << " renumberings" << std::endl ;
+    return true ;
+}
+
+
+/*!
+ * \brief Runs the hold model : each operation extracts the top job and
+ * submits a new one.
+ * \param heap the heap, initially empty.
+ * \param n the number of jobs.
+ * \return the number of operations.
+ */
+template<class Heap>
+size_t hold(Heap& heap, size_t n)
+{	std::mt19937_64 generator(5) ;
+    std::uint32_t id = 0 ;
+    for(size_t i=0; i<n; i++)
+    {	heap.insert(job{static_cast<int>(generator() % 16), id++}) ; }
+    size_t operations = std::max<size_t>(n, 1000000) ;
+    for(size_t i=0; i<operations; i++)
+    {	do_not_optimize(heap.extract_top()) ;
+        heap.insert(job{static_cast<int>(generator() % 16), id++}) ;
+    }
+    return 2*operations ;
+}
+
+template<class Heap>
+void benchmark(const char* name, size_t n)
+{	Heap heap(n) ;
+    stopwatch watch ;
+    size_t operations = hold(heap, n) ;
+    double elapsed = watch.elapsed_ns() ;
+    std::cout << std::setw(22) << name << std::setw(12) << n
+              << std::setw(12) << elapsed / operations << std::endl ;
+}
+
+
+int main(int argc, char** argv)
+{	size_t max_size = max_size_argument(argc, argv, 1000000) ;
+
+    if(not check_fifo_order())
+    {	return 1 ; }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(22) << "heap" << std::setw(12) << "n"
+              << std::setw(12) << "ns/op" << std::endl ;
+    for(size_t n=100; n<=max_size; n*=10)
+    {	benchmark<stable_binary_heap<job>>("stable_heap<uint64>", n) ;
+        benchmark<stable_binary_heap<job, std::uint32_t>>("stable_heap<uint32>", n) ;
+        benchmark<binary_heap<job>>("binary_heap", n) ;
+    }
+    return 0 ;
+}
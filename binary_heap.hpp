@@ -1,19 +1,44 @@
+#ifndef BINARY_HEAP_HPP
+#define BINARY_HEAP_HPP
 
 #include <iostream>
 #include <vector>
+#include <memory>    // allocator
 #include <algorithm> // swap
 #include <stdexcept>
-#include <limits>
+#include "heap_instrumentation.hpp"
+#include "heap_key.hpp"
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+
+// the heap can be used in constant expressions when std::vector can (C++20)
+#if (__cplusplus >= 202002L) && defined(__cpp_lib_constexpr_vector)
+#define BINARY_HEAP_CONSTEXPR constexpr
+#else
+#define BINARY_HEAP_CONSTEXPR
+#endif
 
 
 /*!
  * \brief The binary_heap class implements a maximum binary heap which elements are stored in a
  * sorted vector.
  * Changing this binary heap to a minimum binary heap only requires to modify the code in the
- * sift_up and sift_down methods.
+ * higher method.
+ * The storage is obtained through the given allocator, which allows a heap to
+ * carve its storage from an arena (see the pmr::binary_heap alias below). All
+ * the storage is allocated at construction, insertions never allocate.
+ * Under C++20, all the methods but the stream operator are constexpr, such
+ * that a heap can be used within a constant expression.
+ * The instrumentation policy (see heap_instrumentation.hpp) is notified of
+ * the operations, comparisons, moves and sift levels. The default policy does
+ * nothing and, being an empty base, takes no space.
+ * The elements are compared on the keys given by the KeyOf extractor (see
+ * heap_key.hpp), for instance first_key for std::pair elements, such that the
+ * payloads are not compared on ties. Fundamental keys are compared by value.
  */
-template<class T>
-class binary_heap
+template<class T, class Allocator = std::allocator<T>, class Instrumentation = null_instrumentation, class KeyOf = identity_key>
+class binary_heap : private Instrumentation
 {
 
     public:
@@ -22,46 +47,48 @@ class binary_heap
          * \brief Constructs an empty binary heap with a given
          * maximum size.
          * \param sizeMax the maximum size of the heap.
+         * \param allocator the allocator used to allocate the storage.
          */
-        binary_heap(size_t sizeMax) ;
+        BINARY_HEAP_CONSTEXPR binary_heap(size_t sizeMax, const Allocator& allocator = Allocator()) ;
         /*!
          * \brief Constructs a binary heap from a given vector.
          * The maximum size is set to the vector size.
          * \param v a vector to construct the binary heap from.
+         * \param allocator the allocator used to allocate the storage.
          */
-        binary_heap(const std::vector<T>& v) ;
+        BINARY_HEAP_CONSTEXPR binary_heap(const std::vector<T>& v, const Allocator& allocator = Allocator()) ;
 
         // methods
         /*!
          * \brief Returns the maximum value of the heap.
          * \return the maximum value.
          */
-        T top() const ;
+        BINARY_HEAP_CONSTEXPR T top() const ;
         /*!
          * \brief Removes and return the maximum value of the
          * heap.
          * \return the maximum value.
          */
-        T extract_top() ;
+        BINARY_HEAP_CONSTEXPR T extract_top() ;
 
         /*!
          * \brief Insert a given value within the heap.
          * \param value a value to insert.
          * \throw std::runtime_error if the heap is full.
          */
-        void insert(T value) throw(std::runtime_error) ;
+        BINARY_HEAP_CONSTEXPR void insert(T value) ;
         /*!
          * \brief Removes the value at the given index.
          * \param index the index of the value to remove.
          */
-        void remove(int index) ;
+        BINARY_HEAP_CONSTEXPR void remove(int index) ;
         /*!
          * \brief Changes the priority of the value located
          * at the given index with the given value.
          * \param index the index of the priority value to change.
          * \param priority the new priority value.
          */
-        void change_priority(int index, T priority) ;
+        BINARY_HEAP_CONSTEXPR void change_priority(int index, T priority) ;
 
         /*!
          * \brief Searches the heap for the given value and returns
@@ -71,24 +98,41 @@ class binary_heap
          * \return the index of the value if it has been found,
          * -1 otherwise.
          */
-        int find(T value) ;
+        BINARY_HEAP_CONSTEXPR int find(T value) ;
 
         /*!
          * \brief Checks whether the heap is empty.
          * \return whether the heap is empty.
          */
-        bool empty() const ;
+        BINARY_HEAP_CONSTEXPR bool empty() const ;
         /*!
          * \brief Checks whether the heap is full (its
          * size is equal to the maximum size).
          * \return whether the heap is full.
          */
-        bool full() const ;
+        BINARY_HEAP_CONSTEXPR bool full() const ;
         /*!
          * \brief Returns the current size of the heap.
          * \return the size of the heap.
          */
-        size_t size() const ;
+        BINARY_HEAP_CONSTEXPR size_t size() const ;
+        /*!
+         * \brief Returns a copy of the allocator used by the heap.
+         * \return the allocator.
+         */
+        BINARY_HEAP_CONSTEXPR Allocator get_allocator() const ;
+        /*!
+         * \brief Returns the instrumentation policy, which
+         * exports the counters.
+         * \return the instrumentation policy.
+         */
+        BINARY_HEAP_CONSTEXPR const Instrumentation& instrumentation() const ;
+        /*!
+         * \brief Returns the instrumentation policy, which
+         * exports the counters.
+         * \return the instrumentation policy.
+         */
+        BINARY_HEAP_CONSTEXPR Instrumentation& instrumentation() ;
 
     public:
         // friendly functions
@@ -99,28 +143,42 @@ class binary_heap
          * \param h a binary heap of interest.
          * \return a reference to the stream.
          */
-        template<class U>
-        friend std::ostream& operator << (std::ostream& stream, const binary_heap<U>& h) ;
+        template<class U, class A, class I, class K>
+        friend std::ostream& operator << (std::ostream& stream, const binary_heap<U,A,I,K>& h) ;
 
     private:
+        typedef typename heap_key_traits<KeyOf,T>::key_reference key_reference ;
+
         // methods
+        /*!
+         * \brief Compares the keys of two values.
+         * \param a a value of interest.
+         * \param b a value of interest.
+         * \return whether a has a higher priority than b.
+         */
+        BINARY_HEAP_CONSTEXPR bool higher(const T& a, const T& b) const ;
+        /*!
+         * \brief Removes the maximum value of the heap.
+         */
+        BINARY_HEAP_CONSTEXPR void pop_top() ;
+
         /*!
          * \brief Sifts up the element located at a given index.
          * \param index the index of the element to sift up.
          */
-        void sift_up(int index) ;
+        BINARY_HEAP_CONSTEXPR void sift_up(int index) ;
         /*!
          * \brief Sifts down the element located at a given index.
          * \param index the index of the element to sift down.
          */
-        void sift_down(int index) ;
+        BINARY_HEAP_CONSTEXPR void sift_down(int index) ;
 
         /*!
          * \brief Builds a heap from a vector. Sets the
          * maximum size to the vector size.
          * \param v a vector of interest.
          */
-        void build_heap(const std::vector<T>& v) ;
+        BINARY_HEAP_CONSTEXPR void build_heap(const std::vector<T>& v) ;
 
         /*!
          * \brief Returns the index of the parent of the
@@ -128,21 +186,21 @@ class binary_heap
          * \param index the index of the element of interest.
          * \return the index of the parent.
          */
-        int parent(int index) const ;
+        BINARY_HEAP_CONSTEXPR int parent(int index) const ;
         /*!
          * \brief Returns the index of the left child of the
          * element located at the given index.
          * \param index the index of the element of interest.
          * \return the index of the left child.
          */
-        int left_child(int index) const ;
+        BINARY_HEAP_CONSTEXPR int left_child(int index) const ;
         /*!
          * \brief Returns the index of the right chold of the
          * element located at the given index.
          * \param index the index of the element of interest.
          * \return the index of the right child.
          */
-        int right_child(int index) const ;
+        BINARY_HEAP_CONSTEXPR int right_child(int index) const ;
 
         // fields
         /*!
@@ -156,65 +214,94 @@ class binary_heap
         /*!
          * \brief The vector storing the heap.
          */
-        std::vector<T> _heap ;
+        std::vector<T, Allocator> _heap ;
 } ;
 
 
-template<class T>
-binary_heap<T>::binary_heap(size_t sizeMax)
-    : _sizeMax(sizeMax), _size(0), _heap(sizeMax)
+#if __cplusplus >= 201703L
+namespace pmr
+{
+    /*!
+     * \brief A binary heap which storage is obtained from a
+     * std::pmr::memory_resource, for instance a
+     * std::pmr::monotonic_buffer_resource released in bulk.
+     */
+    template<class T, class Instrumentation = null_instrumentation, class KeyOf = identity_key>
+    using binary_heap = ::binary_heap<T, std::pmr::polymorphic_allocator<T>, Instrumentation, KeyOf> ;
+}
+#endif
+
+
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR binary_heap<T,Allocator,Instrumentation,KeyOf>::binary_heap(size_t sizeMax, const Allocator& allocator)
+    : _sizeMax(sizeMax), _size(0), _heap(sizeMax, allocator)
 {}
 
-template<class T>
-binary_heap<T>::binary_heap(const std::vector<T>& v)
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR binary_heap<T,Allocator,Instrumentation,KeyOf>::binary_heap(const std::vector<T>& v, const Allocator& allocator)
+    : _sizeMax(0), _size(0), _heap(allocator)
 {	this->build_heap(v) ; }
 
 
-template<class T>
-T binary_heap<T>::top() const
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR T binary_heap<T,Allocator,Instrumentation,KeyOf>::top() const
 {	return this->_heap[0] ; }
 
-template<class T>
-T binary_heap<T>::extract_top()
-{	T top = this->_heap[0] ;
-    this->_heap[0] = this->_heap[this->size()-1] ;
-    this->_size-- ;
-    this->sift_down(0) ;
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR T binary_heap<T,Allocator,Instrumentation,KeyOf>::extract_top()
+{	this->begin_operation(heap_operation::extract_top) ;
+    T top = this->_heap[0] ;
+    this->pop_top() ;
+    this->end_operation(heap_operation::extract_top) ;
     return top ;
 }
 
 
-template<class T>
-void binary_heap<T>::insert(T value) throw(std::runtime_error)
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR void binary_heap<T,Allocator,Instrumentation,KeyOf>::insert(T value)
 {	if(this->full())
     {	throw std::runtime_error("binary_heap is full!") ; }
 
+    this->begin_operation(heap_operation::insert) ;
     this->_size++ ;
     this->_heap[this->size()-1] = value ;
+    this->count_moves(1) ;
     this->sift_up(this->size()-1) ;
+    this->end_operation(heap_operation::insert) ;
 }
 
-template<class T>
-void binary_heap<T>::remove(int index)
-{	this->_heap[index] = std::numeric_limits<T>::max() ;
-    this->sift_up(index) ;
-    this->extract_top() ;
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR void binary_heap<T,Allocator,Instrumentation,KeyOf>::remove(int index)
+{	this->begin_operation(heap_operation::remove) ;
+    // move the value up to the top, as if it had the maximum priority
+    while(index > 0)
+    {	std::swap(this->_heap[this->parent(index)], this->_heap[index]) ;
+        this->count_moves(3) ;
+        index = this->parent(index) ;
+        this->count_sift_level(index) ;
+    }
+    this->pop_top() ;
+    this->end_operation(heap_operation::remove) ;
 }
 
 
-template<class T>
-void binary_heap<T>::change_priority(int index, T priority)
-{	T old_priority = this->_heap[index] ;
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR void binary_heap<T,Allocator,Instrumentation,KeyOf>::change_priority(int index, T priority)
+{	this->begin_operation(heap_operation::change_priority) ;
+    T old_priority = this->_heap[index] ;
     this->_heap[index] = priority ;
-    if(priority > old_priority)
+    this->count_moves(1) ;
+    this->count_comparison() ;
+    if(this->higher(priority, old_priority))
     {	this->sift_up(index) ; }
     else
     {	this->sift_down(index) ; }
+    this->end_operation(heap_operation::change_priority) ;
 }
 
 
-template<class T>
-int binary_heap<T>::find(T value)
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR int binary_heap<T,Allocator,Instrumentation,KeyOf>::find(T value)
 {   for(size_t i=0; i<this->size(); i++)
     {   if(this->_heap[i] == value)
         {   return i ; }
@@ -223,77 +310,122 @@ int binary_heap<T>::find(T value)
 }
 
 
-template<class T>
-bool binary_heap<T>::empty() const
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR bool binary_heap<T,Allocator,Instrumentation,KeyOf>::empty() const
 {	return this->size() == 0 ? true : false ; }
 
-template<class T>
-bool binary_heap<T>::full() const
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR bool binary_heap<T,Allocator,Instrumentation,KeyOf>::full() const
 {	if(this->size() == this->_sizeMax)
     {	return true ; }
     return false ;
 }
 
-template<class T>
-size_t binary_heap<T>::size() const
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR size_t binary_heap<T,Allocator,Instrumentation,KeyOf>::size() const
 {	return this->_size ; }
 
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR Allocator binary_heap<T,Allocator,Instrumentation,KeyOf>::get_allocator() const
+{	return this->_heap.get_allocator() ; }
+
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR const Instrumentation& binary_heap<T,Allocator,Instrumentation,KeyOf>::instrumentation() const
+{	return *this ; }
+
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR Instrumentation& binary_heap<T,Allocator,Instrumentation,KeyOf>::instrumentation()
+{	return *this ; }
+
+
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR void binary_heap<T,Allocator,Instrumentation,KeyOf>::pop_top()
+{	this->_heap[0] = this->_heap[this->size()-1] ;
+    this->count_moves(1) ;
+    this->_size-- ;
+    this->sift_down(0) ;
+}
+
+
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR bool binary_heap<T,Allocator,Instrumentation,KeyOf>::higher(const T& a, const T& b) const
+{	key_reference key_a = KeyOf()(a) ;
+    key_reference key_b = KeyOf()(b) ;
+    return key_a > key_b ; // change > to < for min heap
+}
+
 
-template<class T>
-void binary_heap<T>::sift_up(int index)
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR void binary_heap<T,Allocator,Instrumentation,KeyOf>::sift_up(int index)
 {	// std::cerr << "-- sift up " << index << " -- " << std::endl ;
 
-    while((index > 0) and (this->_heap[index]) > this->_heap[this->parent(index)]) // change > to < for min heap
-    {	std::swap(this->_heap[this->parent(index)], this->_heap[index]) ;
+    while(index > 0)
+    {	this->count_comparison() ;
+        if(not this->higher(this->_heap[index], this->_heap[this->parent(index)]))
+        {	break ; }
+        std::swap(this->_heap[this->parent(index)], this->_heap[index]) ;
+        this->count_moves(3) ;
         index = this->parent(index) ;
+        this->count_sift_level(index) ;
     }
 }
 
-template<class T>
-void binary_heap<T>::sift_down(int index)
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR void binary_heap<T,Allocator,Instrumentation,KeyOf>::sift_down(int index)
 {	// std::cerr << "-- sift down " << index << " -- " << std::endl ;
     int maxIndex = index ;
 
     int child_l = this->left_child(index) ;
     int child_r = this->right_child(index) ;
 
-    if((child_l <= static_cast<int>(this->size())) and (this->_heap[child_l] > this->_heap[maxIndex])) // change > to < for min heap
-    {	maxIndex = child_l ; }
-    if((child_r <= static_cast<int>(this->size())) and (this->_heap[child_r] > this->_heap[maxIndex])) // change > to < for min heap
-    {	maxIndex = child_r ; }
+    if(child_l < static_cast<int>(this->size()))
+    {	this->count_comparison() ;
+        if(this->higher(this->_heap[child_l], this->_heap[maxIndex]))
+        {	maxIndex = child_l ; }
+    }
+    if(child_r < static_cast<int>(this->size()))
+    {	this->count_comparison() ;
+        if(this->higher(this->_heap[child_r], this->_heap[maxIndex]))
+        {	maxIndex = child_r ; }
+    }
     if(index != maxIndex)
     {	std::swap(this->_heap[index], this->_heap[maxIndex]) ;
+        this->count_moves(3) ;
+        this->count_sift_level(maxIndex) ;
         this->sift_down(maxIndex) ;
     }
 }
 
 
-template<class T>
-void binary_heap<T>::build_heap(const std::vector<T>& v)
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR void binary_heap<T,Allocator,Instrumentation,KeyOf>::build_heap(const std::vector<T>& v)
 {	// std::cerr << "-- build_heap -- " << std::endl ;
-    this->_heap = v ;
+    this->begin_operation(heap_operation::build_heap) ;
+    this->_heap.assign(v.begin(), v.end()) ;
     this->_sizeMax = v.size() ;
     this->_size = v.size() ;
+    this->count_moves(v.size()) ;
     // enforce binary heap for all non-leaf nodes
     for(int i=static_cast<int>(this->size())/2; i>=0; i--)
     {	this->sift_down(i) ; }
+    this->end_operation(heap_operation::build_heap) ;
 }
 
-template<class T>
-int binary_heap<T>::parent(int index) const
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR int binary_heap<T,Allocator,Instrumentation,KeyOf>::parent(int index) const
 {	return (index-1) / 2 ; }
 
-template<class T>
-int binary_heap<T>::left_child(int index) const
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR int binary_heap<T,Allocator,Instrumentation,KeyOf>::left_child(int index) const
 {	return (2*index) + 1 ; }
 
-template<class T>
-int binary_heap<T>::right_child(int index) const
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+BINARY_HEAP_CONSTEXPR int binary_heap<T,Allocator,Instrumentation,KeyOf>::right_child(int index) const
 {	return (2*index) + 2 ; }
 
 
-template<class T>
-std::ostream& operator << (std::ostream& stream, const binary_heap<T>& h)
+template<class T, class Allocator, class Instrumentation, class KeyOf>
+std::ostream& operator << (std::ostream& stream, const binary_heap<T,Allocator,Instrumentation,KeyOf>& h)
 {	for(const auto& i : h._heap)
     {	stream << i << ' ' ; }
     return stream ;
@@ -304,3 +436,5 @@ std::ostream& operator << (std::ostream& stream, const std::pair<T,U>& p)
 {	stream << '<' << p.first << ' ' << p.second << '>' << ' ' ;
     return stream ;
 }
+
+#endif // BINARY_HEAP_HPP
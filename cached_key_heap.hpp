@@ -0,0 +1,228 @@
+#ifndef CACHED_KEY_HEAP_HPP
+#define CACHED_KEY_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <memory>  // allocator, allocator_traits
+#include <utility> // pair
+#include "binary_heap.hpp"
+#include "heap_key.hpp"
+
+
+/*!
+ * \brief The cached_key_heap class implements a maximum binary heap of
+ * elements which priority is computed from the element by KeyOf, a function
+ * object which may be expensive (a score over several fields). The key is
+ * computed once, when an element is inserted or its priority changed, and is
+ * stored next to it (the decorate-sort-undecorate idiom) : the sifts only
+ * compare the cached keys and never call KeyOf.
+ * It is a binary_heap of (key, element) pairs compared with first_key.
+ */
+template<class T, class KeyOf, class Allocator = std::allocator<T>>
+class cached_key_heap
+{
+    public:
+        typedef typename heap_key_traits<KeyOf,T>::key_type key_type ;
+
+        cached_key_heap() = delete ;
+        /*!
+         * \brief Constructs an empty heap with a given
+         * maximum size.
+         * \param sizeMax the maximum size of the heap.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        cached_key_heap(size_t sizeMax, const Allocator& allocator = Allocator()) ;
+        /*!
+         * \brief Constructs a heap from a given vector, in O(n),
+         * computing each key once. The maximum size is set to the
+         * vector size.
+         * \param v a vector to construct the heap from.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        cached_key_heap(const std::vector<T>& v, const Allocator& allocator = Allocator()) ;
+
+        // methods
+        /*!
+         * \brief Returns the maximum value of the heap.
+         * \return the maximum value.
+         */
+        T top() const ;
+        /*!
+         * \brief Returns the cached key of the maximum value
+         * of the heap.
+         * \return the key of the maximum value.
+         */
+        key_type top_key() const ;
+        /*!
+         * \brief Removes and return the maximum value of the
+         * heap.
+         * \return the maximum value.
+         */
+        T extract_top() ;
+
+        /*!
+         * \brief Insert a given value within the heap, computing
+         * its key once.
+         * \param value a value to insert.
+         * \throw std::runtime_error if the heap is full.
+         */
+        void insert(T value) ;
+        /*!
+         * \brief Removes the value at the given index.
+         * \param index the index of the value to remove.
+         */
+        void remove(int index) ;
+        /*!
+         * \brief Changes the value located at the given index,
+         * computing its key once.
+         * \param index the index of the value to change.
+         * \param priority the new value.
+         */
+        void change_priority(int index, T priority) ;
+
+        /*!
+         * \brief Searches the heap for the given value and returns
+         * its index. If it could not be found, -1 is returned. This
+         * method is not time efficient (O(n)).
+         * \param value a value to find in the heap.
+         * \return the index of the value if it has been found,
+         * -1 otherwise.
+         */
+        int find(T value) ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * a cached key heap to a stream, as <key value> pairs.
+         * \param stream an output stream of interest.
+         * \param h a cached key heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U, class K, class A>
+        friend std::ostream& operator << (std::ostream& stream, const cached_key_heap<U,K,A>& h) ;
+
+    private:
+        typedef std::pair<key_type, T> entry_type ;
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<entry_type> entry_allocator_type ;
+
+        // methods
+        /*!
+         * \brief Decorates a value with its key.
+         * \param value a value of interest.
+         * \return the value along with its key.
+         */
+        static entry_type decorate(T value) ;
+        /*!
+         * \brief Decorates the values of a vector.
+         * \param v a vector of interest.
+         * \return the values along with their keys.
+         */
+        static std::vector<entry_type> decorate(const std::vector<T>& v) ;
+
+        // fields
+        /*!
+         * \brief The heap of the values along with their keys.
+         */
+        binary_heap<entry_type, entry_allocator_type, null_instrumentation, first_key> _heap ;
+} ;
+
+
+template<class T, class KeyOf, class Allocator>
+cached_key_heap<T,KeyOf,Allocator>::cached_key_heap(size_t sizeMax, const Allocator& allocator)
+    : _heap(sizeMax, entry_allocator_type(allocator))
+{}
+
+template<class T, class KeyOf, class Allocator>
+cached_key_heap<T,KeyOf,Allocator>::cached_key_heap(const std::vector<T>& v, const Allocator& allocator)
+    : _heap(decorate(v), entry_allocator_type(allocator))
+{}
+
+
+template<class T, class KeyOf, class Allocator>
+T cached_key_heap<T,KeyOf,Allocator>::top() const
+{	return this->_heap.top().second ; }
+
+template<class T, class KeyOf, class Allocator>
+typename cached_key_heap<T,KeyOf,Allocator>::key_type cached_key_heap<T,KeyOf,Allocator>::top_key() const
+{	return this->_heap.top().first ; }
+
+template<class T, class KeyOf, class Allocator>
+T cached_key_heap<T,KeyOf,Allocator>::extract_top()
+{	return this->_heap.extract_top().second ; }
+
+
+template<class T, class KeyOf, class Allocator>
+void cached_key_heap<T,KeyOf,Allocator>::insert(T value)
+{	this->_heap.insert(decorate(std::move(value))) ; }
+
+template<class T, class KeyOf, class Allocator>
+void cached_key_heap<T,KeyOf,Allocator>::remove(int index)
+{	this->_heap.remove(index) ; }
+
+template<class T, class KeyOf, class Allocator>
+void cached_key_heap<T,KeyOf,Allocator>::change_priority(int index, T priority)
+{	this->_heap.change_priority(index, decorate(std::move(priority))) ; }
+
+
+template<class T, class KeyOf, class Allocator>
+int cached_key_heap<T,KeyOf,Allocator>::find(T value)
+{	// the key of an equal value is equal, such that it can be
+    // found along with its key
+    return this->_heap.find(decorate(std::move(value))) ;
+}
+
+
+template<class T, class KeyOf, class Allocator>
+bool cached_key_heap<T,KeyOf,Allocator>::empty() const
+{	return this->_heap.empty() ; }
+
+template<class T, class KeyOf, class Allocator>
+bool cached_key_heap<T,KeyOf,Allocator>::full() const
+{	return this->_heap.full() ; }
+
+template<class T, class KeyOf, class Allocator>
+size_t cached_key_heap<T,KeyOf,Allocator>::size() const
+{	return this->_heap.size() ; }
+
+
+template<class T, class KeyOf, class Allocator>
+typename cached_key_heap<T,KeyOf,Allocator>::entry_type cached_key_heap<T,KeyOf,Allocator>::decorate(T value)
+{	key_type key = KeyOf()(value) ;
+    return entry_type(std::move(key), std::move(value)) ;
+}
+
+template<class T, class KeyOf, class Allocator>
+std::vector<typename cached_key_heap<T,KeyOf,Allocator>::entry_type> cached_key_heap<T,KeyOf,Allocator>::decorate(const std::vector<T>& v)
+{	std::vector<entry_type> entries ;
+    entries.reserve(v.size()) ;
+    for(const T& value : v)
+    {	entries.push_back(decorate(value)) ; }
+    return entries ;
+}
+
+
+template<class T, class KeyOf, class Allocator>
+std::ostream& operator << (std::ostream& stream, const cached_key_heap<T,KeyOf,Allocator>& h)
+{	stream << h._heap ;
+    return stream ;
+}
+
+#endif // CACHED_KEY_HEAP_HPP
@@ -0,0 +1,238 @@
+#ifndef COUNTED_HEAP_HPP
+#define COUNTED_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <memory>     // allocator, allocator_traits
+#include <functional> // less, hash, equal_to
+#include <utility>    // move, pair
+#include <stdexcept>
+#include "heap_algorithm.hpp"
+
+
+/*!
+ * \brief The counted_heap class implements a maximum binary heap which stores
+ * each distinct key once, along with its number of occurrences, for workloads
+ * with many duplicates (millions of elements over a few thousand priorities).
+ * The heap only holds the distinct keys and a hash map gives the count of each
+ * of them : inserting a key which is already present increments its count in
+ * O(1) without sifting, and extracting the top decrements its count, the key
+ * leaving the heap when it reaches 0. The memory and the sift work thus scale
+ * with the number of distinct keys rather than with the number of elements.
+ * The keys must be hashable. The elements of a key being merged, they have no
+ * index and the index based remove() and change_priority() are not provided.
+ */
+template<class T, class Allocator = std::allocator<T>>
+class counted_heap
+{
+    public:
+        counted_heap() = delete ;
+        /*!
+         * \brief Constructs an empty heap with a given
+         * maximum size.
+         * \param sizeMax the maximum number of elements of the heap,
+         * duplicates included.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        counted_heap(size_t sizeMax, const Allocator& allocator = Allocator()) ;
+        /*!
+         * \brief Constructs a heap from a given vector, in O(n).
+         * The maximum size is set to the vector size.
+         * \param v a vector to construct the heap from.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        counted_heap(const std::vector<T>& v, const Allocator& allocator = Allocator()) ;
+
+        // methods
+        /*!
+         * \brief Returns the maximum value of the heap.
+         * \return the maximum value.
+         */
+        T top() const ;
+        /*!
+         * \brief Returns the number of occurrences of the
+         * maximum value of the heap.
+         * \return the count of the maximum value.
+         */
+        size_t top_count() const ;
+        /*!
+         * \brief Removes one occurrence of the maximum value
+         * of the heap and returns it.
+         * \return the maximum value.
+         */
+        T extract_top() ;
+
+        /*!
+         * \brief Insert a given value within the heap, in O(1)
+         * if the value is already present.
+         * \param value a value to insert.
+         * \param count the number of occurrences to insert.
+         * \throw std::runtime_error if the heap is full.
+         */
+        void insert(T value, size_t count = 1) ;
+
+        /*!
+         * \brief Returns the number of occurrences of a value,
+         * in O(1).
+         * \param value a value of interest.
+         * \return the count of the value, 0 if it is absent.
+         */
+        size_t count(const T& value) const ;
+        /*!
+         * \brief Returns the number of distinct values of the
+         * heap, that is the size of the underlying heap.
+         * \return the number of distinct values.
+         */
+        size_t distinct() const ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap,
+         * duplicates included.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * a counted heap to a stream, as key*count pairs.
+         * \param stream an output stream of interest.
+         * \param h a counted heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U, class A>
+        friend std::ostream& operator << (std::ostream& stream, const counted_heap<U,A>& h) ;
+
+    private:
+        typedef std::ptrdiff_t index_type ;
+        typedef std::less<T> compare_type ; // change to std::greater<T> for min heap
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<const T, size_t>> map_allocator_type ;
+        typedef std::unordered_map<T, size_t, std::hash<T>, std::equal_to<T>, map_allocator_type> map_type ;
+
+        // fields
+        /*!
+         * \brief The maximum number of elements of the heap.
+         */
+        size_t _sizeMax ;
+        /*!
+         * \brief The number of elements of the heap, duplicates
+         * included.
+         */
+        size_t _size ;
+        /*!
+         * \brief The heap of the distinct values, which grows with
+         * their number.
+         */
+        std::vector<T, Allocator> _heap ;
+        /*!
+         * \brief The number of occurrences of each distinct value.
+         */
+        map_type _counts ;
+} ;
+
+
+template<class T, class Allocator>
+counted_heap<T,Allocator>::counted_heap(size_t sizeMax, const Allocator& allocator)
+    : _sizeMax(sizeMax), _size(0), _heap(allocator), _counts(0, std::hash<T>(), std::equal_to<T>(), map_allocator_type(allocator))
+{}
+
+template<class T, class Allocator>
+counted_heap<T,Allocator>::counted_heap(const std::vector<T>& v, const Allocator& allocator)
+    : _sizeMax(v.size()), _size(v.size()), _heap(allocator), _counts(0, std::hash<T>(), std::equal_to<T>(), map_allocator_type(allocator))
+{	for(const T& value : v)
+    {	if(this->_counts[value]++ == 0)
+        {	this->_heap.push_back(value) ; }
+    }
+    heap_make(this->_heap.begin(), this->_heap.end(), compare_type()) ;
+}
+
+
+template<class T, class Allocator>
+T counted_heap<T,Allocator>::top() const
+{	return this->_heap[0] ; }
+
+template<class T, class Allocator>
+size_t counted_heap<T,Allocator>::top_count() const
+{	return this->_counts.find(this->_heap[0])->second ; }
+
+template<class T, class Allocator>
+T counted_heap<T,Allocator>::extract_top()
+{	T top = this->_heap[0] ;
+    this->_size-- ;
+    auto it = this->_counts.find(top) ;
+    if(--it->second > 0)
+    {	return top ; }
+    // the last occurrence, the value leaves the heap
+    this->_counts.erase(it) ;
+    T last = std::move(this->_heap.back()) ;
+    this->_heap.pop_back() ;
+    if(not this->_heap.empty())
+    {	heap_sift_down_floyd<2>(this->_heap.begin(), static_cast<index_type>(this->_heap.size()), 0, std::move(last), compare_type()) ; }
+    return top ;
+}
+
+
+template<class T, class Allocator>
+void counted_heap<T,Allocator>::insert(T value, size_t count)
+{	if(count > this->_sizeMax - this->_size)
+    {	throw std::runtime_error("counted_heap is full!") ; }
+    if(count == 0)
+    {	return ; }
+
+    this->_size += count ;
+    size_t& occurrences = this->_counts[value] ;
+    occurrences += count ;
+    if(occurrences > count)
+    {	return ; }
+    // a new distinct value
+    index_type hole = this->_heap.size() ;
+    this->_heap.push_back(value) ;
+    heap_sift_up<2>(this->_heap.begin(), 0, hole, std::move(value), compare_type()) ;
+}
+
+
+template<class T, class Allocator>
+size_t counted_heap<T,Allocator>::count(const T& value) const
+{	auto it = this->_counts.find(value) ;
+    return it == this->_counts.end() ? 0 : it->second ;
+}
+
+template<class T, class Allocator>
+size_t counted_heap<T,Allocator>::distinct() const
+{	return this->_heap.size() ; }
+
+
+template<class T, class Allocator>
+bool counted_heap<T,Allocator>::empty() const
+{	return this->size() == 0 ; }
+
+template<class T, class Allocator>
+bool counted_heap<T,Allocator>::full() const
+{	return this->size() == this->_sizeMax ; }
+
+template<class T, class Allocator>
+size_t counted_heap<T,Allocator>::size() const
+{	return this->_size ; }
+
+
+template<class T, class Allocator>
+std::ostream& operator << (std::ostream& stream, const counted_heap<T,Allocator>& h)
+{	for(const auto& value : h._heap)
+    {	stream << value << '*' << h._counts.find(value)->second << ' ' ; }
+    return stream ;
+}
+
+#endif // COUNTED_HEAP_HPP
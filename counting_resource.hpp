@@ -0,0 +1,115 @@
+#ifndef COUNTING_RESOURCE_HPP
+#define COUNTING_RESOURCE_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+
+/*!
+ * \brief The counting_resource class is a memory resource which forwards
+ * all the requests to an upstream resource and counts them.
+ * Used as the upstream of an arena, or installed as the default resource, it
+ * allows to check that no allocation reaches the global allocator on a given
+ * code path.
+ */
+class counting_resource : public std::pmr::memory_resource
+{
+    public:
+        /*!
+         * \brief Constructs a counting resource forwarding to the
+         * given upstream resource.
+         * \param upstream the resource serving the requests.
+         */
+        explicit counting_resource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) ;
+
+        // methods
+        /*!
+         * \brief Returns the number of allocations served so far.
+         * \return the number of allocations.
+         */
+        size_t allocations() const ;
+        /*!
+         * \brief Returns the number of deallocations served so far.
+         * \return the number of deallocations.
+         */
+        size_t deallocations() const ;
+        /*!
+         * \brief Returns the number of bytes allocated so far.
+         * \return the number of bytes allocated.
+         */
+        size_t bytes_allocated() const ;
+        /*!
+         * \brief Resets all the counters to 0.
+         */
+        void reset() ;
+        /*!
+         * \brief Returns the upstream resource.
+         * \return the upstream resource.
+         */
+        std::pmr::memory_resource* upstream() const ;
+
+    private:
+        // methods
+        void* do_allocate(size_t bytes, size_t alignment) override ;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override ;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override ;
+
+        // fields
+        /*!
+         * \brief The resource serving the requests.
+         */
+        std::pmr::memory_resource* _upstream ;
+        /*!
+         * \brief The number of allocations.
+         */
+        size_t _allocations ;
+        /*!
+         * \brief The number of deallocations.
+         */
+        size_t _deallocations ;
+        /*!
+         * \brief The number of bytes allocated.
+         */
+        size_t _bytes ;
+} ;
+
+
+inline counting_resource::counting_resource(std::pmr::memory_resource* upstream)
+    : _upstream(upstream), _allocations(0), _deallocations(0), _bytes(0)
+{}
+
+inline size_t counting_resource::allocations() const
+{	return this->_allocations ; }
+
+inline size_t counting_resource::deallocations() const
+{	return this->_deallocations ; }
+
+inline size_t counting_resource::bytes_allocated() const
+{	return this->_bytes ; }
+
+inline void counting_resource::reset()
+{	this->_allocations = 0 ;
+    this->_deallocations = 0 ;
+    this->_bytes = 0 ;
+}
+
+inline std::pmr::memory_resource* counting_resource::upstream() const
+{	return this->_upstream ; }
+
+
+inline void* counting_resource::do_allocate(size_t bytes, size_t alignment)
+{	void* p = this->_upstream->allocate(bytes, alignment) ;
+    this->_allocations++ ;
+    this->_bytes += bytes ;
+    return p ;
+}
+
+inline void counting_resource::do_deallocate(void* p, size_t bytes, size_t alignment)
+{	this->_upstream->deallocate(p, bytes, alignment) ;
+    this->_deallocations++ ;
+}
+
+inline bool counting_resource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{	return this == &other ; }
+
+#endif // COUNTING_RESOURCE_HPP
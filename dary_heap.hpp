@@ -0,0 +1,302 @@
+#ifndef DARY_HEAP_HPP
+#define DARY_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <memory>     // allocator
+#include <functional> // less
+#include <utility>    // move
+#include <stdexcept>
+#include "heap_algorithm.hpp"
+
+
+/*!
+ * \brief The strategies to sift down the last element after an extraction.
+ */
+enum class heap_sift
+{	/*!
+     * \brief Compares the element with the largest child at each level.
+     */
+    standard,
+    /*!
+     * \brief Moves the hole down to a leaf, then sifts the element up
+     * (Floyd), saving one comparison per level.
+     */
+    floyd
+} ;
+
+/*!
+ * \brief The heap_config class gathers the tuning knobs of dary_heap :
+ * the arity, the sift strategy of the extractions, the selection of the
+ * largest child with a mask instead of a branch and the prefetching of
+ * the grand children while sifting down.
+ */
+template<size_t Arity = 4, heap_sift Sift = heap_sift::floyd, bool Branchless = false, bool Prefetch = false>
+struct heap_config
+{	static_assert(Arity >= 2, "heap arity must be at least 2") ;
+    static constexpr size_t arity = Arity ;
+    static constexpr heap_sift sift = Sift ;
+    static constexpr bool branchless = Branchless ;
+    static constexpr bool prefetch = Prefetch ;
+} ;
+
+
+/*!
+ * \brief The dary_heap class implements a maximum d-ary heap with the same
+ * interface as binary_heap, on top of the kernels of heap_algorithm.hpp. Its
+ * layout and sift strategies are set by a heap_config, such that they can be
+ * tuned for a workload and a machine (see benchmark/heap_autotune.cpp).
+ */
+template<class T, class Config = heap_config<>, class Allocator = std::allocator<T>>
+class dary_heap
+{
+    public:
+        dary_heap() = delete ;
+        /*!
+         * \brief Constructs an empty heap with a given
+         * maximum size.
+         * \param sizeMax the maximum size of the heap.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        dary_heap(size_t sizeMax, const Allocator& allocator = Allocator()) ;
+        /*!
+         * \brief Constructs a heap from a given vector, in O(n).
+         * The maximum size is set to the vector size.
+         * \param v a vector to construct the heap from.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        dary_heap(const std::vector<T>& v, const Allocator& allocator = Allocator()) ;
+
+        // methods
+        /*!
+         * \brief Returns the maximum value of the heap.
+         * \return the maximum value.
+         */
+        T top() const ;
+        /*!
+         * \brief Removes and return the maximum value of the
+         * heap.
+         * \return the maximum value.
+         */
+        T extract_top() ;
+
+        /*!
+         * \brief Insert a given value within the heap.
+         * \param value a value to insert.
+         * \throw std::runtime_error if the heap is full.
+         */
+        void insert(T value) ;
+        /*!
+         * \brief Removes the value at the given index.
+         * \param index the index of the value to remove.
+         */
+        void remove(int index) ;
+        /*!
+         * \brief Changes the priority of the value located
+         * at the given index with the given value.
+         * \param index the index of the priority value to change.
+         * \param priority the new priority value.
+         */
+        void change_priority(int index, T priority) ;
+
+        /*!
+         * \brief Searches the heap for the given value and returns
+         * its index. If it could not be found, -1 is returned. This
+         * method is not time efficient (O(n)).
+         * \param value a value to find in the heap.
+         * \return the index of the value if it has been found,
+         * -1 otherwise.
+         */
+        int find(T value) const ;
+        /*!
+         * \brief Returns the value at the given index, the values
+         * being in the order of the storage.
+         * \param index the index of the value.
+         * \return the value.
+         */
+        const T& at(int index) const ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * a d-ary heap to a stream.
+         * \param stream an output stream of interest.
+         * \param h a d-ary heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U, class C, class A>
+        friend std::ostream& operator << (std::ostream& stream, const dary_heap<U,C,A>& h) ;
+
+    private:
+        typedef std::ptrdiff_t index_type ;
+        typedef std::less<T> compare_type ; // change to std::greater<T> for min heap
+
+        // methods
+        /*!
+         * \brief Sifts down a value from a hole, along the path of
+         * the largest children.
+         * \param hole the index of the hole.
+         * \param value the value to place.
+         * \param floyd whether Floyd's strategy is used.
+         */
+        void sift_down(index_type hole, T value, bool floyd) ;
+
+        // fields
+        /*!
+         * \brief The maximum size of the heap.
+         */
+        size_t _sizeMax ;
+        /*!
+         * \brief The current size of the heap.
+         */
+        size_t _size ;
+        /*!
+         * \brief The vector storing the heap.
+         */
+        std::vector<T, Allocator> _heap ;
+} ;
+
+
+template<class T, class Config, class Allocator>
+dary_heap<T,Config,Allocator>::dary_heap(size_t sizeMax, const Allocator& allocator)
+    : _sizeMax(sizeMax), _size(0), _heap(sizeMax, allocator)
+{}
+
+template<class T, class Config, class Allocator>
+dary_heap<T,Config,Allocator>::dary_heap(const std::vector<T>& v, const Allocator& allocator)
+    : _sizeMax(v.size()), _size(v.size()), _heap(v.begin(), v.end(), allocator)
+{	heap_make<Config::arity>(this->_heap.begin(), this->_heap.end(), compare_type()) ; }
+
+
+template<class T, class Config, class Allocator>
+T dary_heap<T,Config,Allocator>::top() const
+{	return this->_heap[0] ; }
+
+template<class T, class Config, class Allocator>
+T dary_heap<T,Config,Allocator>::extract_top()
+{	T top = std::move(this->_heap[0]) ;
+    this->_size-- ;
+    if(this->size() > 0)
+    {	this->sift_down(0, std::move(this->_heap[this->size()]), Config::sift == heap_sift::floyd) ; }
+    return top ;
+}
+
+
+template<class T, class Config, class Allocator>
+void dary_heap<T,Config,Allocator>::insert(T value)
+{	if(this->full())
+    {	throw std::runtime_error("dary_heap is full!") ; }
+
+    index_type hole = this->size() ;
+    this->_size++ ;
+    heap_sift_up<Config::arity>(this->_heap.begin(), 0, hole, std::move(value), compare_type()) ;
+}
+
+template<class T, class Config, class Allocator>
+void dary_heap<T,Config,Allocator>::remove(int index)
+{	// move the hole to the top, as if the value had the maximum priority
+    index_type hole = index ;
+    while(hole > 0)
+    {	index_type parent = heap_parent<Config::arity>(hole) ;
+        this->_heap[hole] = std::move(this->_heap[parent]) ;
+        hole = parent ;
+    }
+    this->_size-- ;
+    if(this->size() > 0)
+    {	this->sift_down(0, std::move(this->_heap[this->size()]), Config::sift == heap_sift::floyd) ; }
+}
+
+
+template<class T, class Config, class Allocator>
+void dary_heap<T,Config,Allocator>::change_priority(int index, T priority)
+{	if(compare_type()(this->_heap[index], priority))
+    {	heap_sift_up<Config::arity>(this->_heap.begin(), 0, index, std::move(priority), compare_type()) ; }
+    else
+    {	this->sift_down(index, std::move(priority), false) ; }
+}
+
+
+template<class T, class Config, class Allocator>
+int dary_heap<T,Config,Allocator>::find(T value) const
+{   for(size_t i=0; i<this->size(); i++)
+    {   if(this->_heap[i] == value)
+        {   return i ; }
+    }
+    return -1 ;
+}
+
+template<class T, class Config, class Allocator>
+const T& dary_heap<T,Config,Allocator>::at(int index) const
+{	return this->_heap[index] ; }
+
+
+template<class T, class Config, class Allocator>
+bool dary_heap<T,Config,Allocator>::empty() const
+{	return this->size() == 0 ; }
+
+template<class T, class Config, class Allocator>
+bool dary_heap<T,Config,Allocator>::full() const
+{	return this->size() == this->_sizeMax ; }
+
+template<class T, class Config, class Allocator>
+size_t dary_heap<T,Config,Allocator>::size() const
+{	return this->_size ; }
+
+
+template<class T, class Config, class Allocator>
+void dary_heap<T,Config,Allocator>::sift_down(index_type hole, T value, bool floyd)
+{	const size_t arity = Config::arity ;
+    auto first = this->_heap.begin() ;
+    index_type len = this->size() ;
+    index_type top = hole ;
+    compare_type comp ;
+    while(heap_first_child<arity>(hole) < len)
+    {	index_type child = heap_first_child<arity>(hole) ;
+#if defined(__GNUC__)
+        if(Config::prefetch)
+        {	// the grand children are contiguous, from the first child of the first child
+            index_type grand_child = heap_first_child<arity>(child) ;
+            if(grand_child < len)
+            {	__builtin_prefetch(&first[grand_child]) ; }
+        }
+#endif
+        child = Config::branchless ? heap_largest_child_branchless<arity>(first, len, child, comp)
+                                   : heap_largest_child<arity>(first, len, child, comp) ;
+        if((not floyd) and (not comp(value, first[child])))
+        {	break ; }
+        first[hole] = std::move(first[child]) ;
+        hole = child ;
+    }
+    if(floyd)
+    {	heap_sift_up<arity>(first, top, hole, std::move(value), comp) ; }
+    else
+    {	first[hole] = std::move(value) ; }
+}
+
+
+template<class T, class Config, class Allocator>
+std::ostream& operator << (std::ostream& stream, const dary_heap<T,Config,Allocator>& h)
+{	for(size_t i=0; i<h.size(); i++)
+    {	stream << h._heap[i] << ' ' ; }
+    return stream ;
+}
+
+#endif // DARY_HEAP_HPP
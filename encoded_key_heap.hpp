@@ -0,0 +1,203 @@
+#ifndef ENCODED_KEY_HEAP_HPP
+#define ENCODED_KEY_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <memory> // allocator, allocator_traits
+#include "dary_heap.hpp"
+#include "key_encoding.hpp"
+
+
+/*!
+ * \brief The encoded_key_heap class implements a maximum heap of keys which
+ * are stored as their order-preserving codes (see key_encoding.hpp) : the keys
+ * are encoded on insertion and decoded on extraction, and the sifts compare
+ * unsigned integers. For float and double keys, this replaces the floating
+ * point comparisons with integer ones and gives the NaNs a place in the order
+ * (IEEE-754 totalOrder : the positive NaNs are above +infinity), where the
+ * floating point comparisons would break the heap.
+ * It is a dary_heap of codes, configured by a heap_config.
+ */
+template<class T, class Config = heap_config<>, class Allocator = std::allocator<T>>
+class encoded_key_heap
+{
+    public:
+        typedef key_encoding<T> encoding_type ;
+        typedef typename encoding_type::code_type code_type ;
+
+        encoded_key_heap() = delete ;
+        /*!
+         * \brief Constructs an empty heap with a given
+         * maximum size.
+         * \param sizeMax the maximum size of the heap.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        encoded_key_heap(size_t sizeMax, const Allocator& allocator = Allocator()) ;
+        /*!
+         * \brief Constructs a heap from a given vector, in O(n).
+         * The maximum size is set to the vector size.
+         * \param v a vector to construct the heap from.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        encoded_key_heap(const std::vector<T>& v, const Allocator& allocator = Allocator()) ;
+
+        // methods
+        /*!
+         * \brief Returns the maximum value of the heap.
+         * \return the maximum value.
+         */
+        T top() const ;
+        /*!
+         * \brief Removes and return the maximum value of the
+         * heap.
+         * \return the maximum value.
+         */
+        T extract_top() ;
+
+        /*!
+         * \brief Insert a given value within the heap.
+         * \param value a value to insert.
+         * \throw std::runtime_error if the heap is full.
+         */
+        void insert(T value) ;
+        /*!
+         * \brief Removes the value at the given index.
+         * \param index the index of the value to remove.
+         */
+        void remove(int index) ;
+        /*!
+         * \brief Changes the priority of the value located
+         * at the given index with the given value.
+         * \param index the index of the priority value to change.
+         * \param priority the new priority value.
+         */
+        void change_priority(int index, T priority) ;
+
+        /*!
+         * \brief Searches the heap for the given value and returns
+         * its index. If it could not be found, -1 is returned. The
+         * codes are compared, such that a NaN can be found. This
+         * method is not time efficient (O(n)).
+         * \param value a value to find in the heap.
+         * \return the index of the value if it has been found,
+         * -1 otherwise.
+         */
+        int find(T value) const ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * an encoded key heap to a stream.
+         * \param stream an output stream of interest.
+         * \param h an encoded key heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U, class C, class A>
+        friend std::ostream& operator << (std::ostream& stream, const encoded_key_heap<U,C,A>& h) ;
+
+    private:
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<code_type> code_allocator_type ;
+
+        // methods
+        /*!
+         * \brief Encodes the values of a vector.
+         * \param v a vector of interest.
+         * \return the codes of the values.
+         */
+        static std::vector<code_type> encode(const std::vector<T>& v) ;
+
+        // fields
+        /*!
+         * \brief The heap of the codes.
+         */
+        dary_heap<code_type, Config, code_allocator_type> _heap ;
+} ;
+
+
+template<class T, class Config, class Allocator>
+encoded_key_heap<T,Config,Allocator>::encoded_key_heap(size_t sizeMax, const Allocator& allocator)
+    : _heap(sizeMax, code_allocator_type(allocator))
+{}
+
+template<class T, class Config, class Allocator>
+encoded_key_heap<T,Config,Allocator>::encoded_key_heap(const std::vector<T>& v, const Allocator& allocator)
+    : _heap(encode(v), code_allocator_type(allocator))
+{}
+
+
+template<class T, class Config, class Allocator>
+T encoded_key_heap<T,Config,Allocator>::top() const
+{	return encoding_type::decode(this->_heap.top()) ; }
+
+template<class T, class Config, class Allocator>
+T encoded_key_heap<T,Config,Allocator>::extract_top()
+{	return encoding_type::decode(this->_heap.extract_top()) ; }
+
+
+template<class T, class Config, class Allocator>
+void encoded_key_heap<T,Config,Allocator>::insert(T value)
+{	this->_heap.insert(encoding_type::encode(value)) ; }
+
+template<class T, class Config, class Allocator>
+void encoded_key_heap<T,Config,Allocator>::remove(int index)
+{	this->_heap.remove(index) ; }
+
+template<class T, class Config, class Allocator>
+void encoded_key_heap<T,Config,Allocator>::change_priority(int index, T priority)
+{	this->_heap.change_priority(index, encoding_type::encode(priority)) ; }
+
+
+template<class T, class Config, class Allocator>
+int encoded_key_heap<T,Config,Allocator>::find(T value) const
+{	return this->_heap.find(encoding_type::encode(value)) ; }
+
+
+template<class T, class Config, class Allocator>
+bool encoded_key_heap<T,Config,Allocator>::empty() const
+{	return this->_heap.empty() ; }
+
+template<class T, class Config, class Allocator>
+bool encoded_key_heap<T,Config,Allocator>::full() const
+{	return this->_heap.full() ; }
+
+template<class T, class Config, class Allocator>
+size_t encoded_key_heap<T,Config,Allocator>::size() const
+{	return this->_heap.size() ; }
+
+
+template<class T, class Config, class Allocator>
+std::vector<typename encoded_key_heap<T,Config,Allocator>::code_type> encoded_key_heap<T,Config,Allocator>::encode(const std::vector<T>& v)
+{	std::vector<code_type> codes ;
+    codes.reserve(v.size()) ;
+    for(const T& value : v)
+    {	codes.push_back(encoding_type::encode(value)) ; }
+    return codes ;
+}
+
+
+template<class T, class Config, class Allocator>
+std::ostream& operator << (std::ostream& stream, const encoded_key_heap<T,Config,Allocator>& h)
+{	for(size_t i=0; i<h.size(); i++)
+    {	stream << encoded_key_heap<T,Config,Allocator>::encoding_type::decode(h._heap.at(i)) << ' ' ; }
+    return stream ;
+}
+
+#endif // ENCODED_KEY_HEAP_HPP
@@ -0,0 +1,252 @@
+#ifndef HEAP_ALGORITHM_HPP
+#define HEAP_ALGORITHM_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <functional> // less
+#include <utility>    // move
+
+/*
+ * Heap algorithms working in place, on the caller memory, through random
+ * access iterators. As with the standard algorithms, the range is a maximum
+ * heap with respect to comp (comp(a,b) is a < b) and the sorts are ascending.
+ *
+ * The heaps are Arity-ary heaps : the children of the element at index i are
+ * at indices Arity*i+1 to Arity*i+Arity. The sift routines move a hole rather
+ * than swapping elements, which costs one move per level instead of three.
+ */
+
+
+/*!
+ * \brief Returns the index of the parent of the element
+ * located at the given index.
+ * \param index the index of the element of interest.
+ * \return the index of the parent.
+ */
+template<size_t Arity, class Index>
+Index heap_parent(Index index)
+{	return (index - 1) / static_cast<Index>(Arity) ; }
+
+/*!
+ * \brief Returns the index of the first child of the element
+ * located at the given index.
+ * \param index the index of the element of interest.
+ * \return the index of the first child.
+ */
+template<size_t Arity, class Index>
+Index heap_first_child(Index index)
+{	return static_cast<Index>(Arity)*index + 1 ; }
+
+
+/*!
+ * \brief Sifts up a value from a hole. The elements on the path from the
+ * hole to the top index which are smaller than the value are moved down one
+ * level and the value is moved into the final hole.
+ * \param first the beginning of the heap.
+ * \param top the index above which the value cannot go.
+ * \param hole the index of the hole.
+ * \param value the value to place.
+ * \param comp the comparison function.
+ */
+template<size_t Arity, class RandomIt, class Compare>
+void heap_sift_up(RandomIt first,
+                  typename std::iterator_traits<RandomIt>::difference_type top,
+                  typename std::iterator_traits<RandomIt>::difference_type hole,
+                  typename std::iterator_traits<RandomIt>::value_type value,
+                  Compare comp)
+{	while(hole > top)
+    {	auto parent = heap_parent<Arity>(hole) ;
+        if(not comp(first[parent], value))
+        {	break ; }
+        first[hole] = std::move(first[parent]) ;
+        hole = parent ;
+    }
+    first[hole] = std::move(value) ;
+}
+
+/*!
+ * \brief Returns the index of the largest child of an element.
+ * \param first the beginning of the heap.
+ * \param len the size of the heap.
+ * \param child the index of the first child, which must exist.
+ * \param comp the comparison function.
+ * \return the index of the largest child.
+ */
+template<size_t Arity, class RandomIt, class Compare>
+typename std::iterator_traits<RandomIt>::difference_type
+heap_largest_child(RandomIt first,
+                   typename std::iterator_traits<RandomIt>::difference_type len,
+                   typename std::iterator_traits<RandomIt>::difference_type child,
+                   Compare comp)
+{	auto largest = child ;
+    if(len - child >= static_cast<decltype(len)>(Arity))
+    {	// all the children exist, constant trip count
+        for(auto i=child+1; i<child+static_cast<decltype(child)>(Arity); i++)
+        {	if(comp(first[largest], first[i]))
+            {	largest = i ; }
+        }
+    }
+    else
+    {	for(auto i=child+1; i<len; i++)
+        {	if(comp(first[largest], first[i]))
+            {	largest = i ; }
+        }
+    }
+    return largest ;
+}
+
+/*!
+ * \brief Returns the index of the largest child of an element, selecting it
+ * with a mask instead of a branch, which avoids the mispredictions when the
+ * order of the children is random.
+ * \param first the beginning of the heap.
+ * \param len the size of the heap.
+ * \param child the index of the first child, which must exist.
+ * \param comp the comparison function.
+ * \return the index of the largest child.
+ */
+template<size_t Arity, class RandomIt, class Compare>
+typename std::iterator_traits<RandomIt>::difference_type
+heap_largest_child_branchless(RandomIt first,
+                              typename std::iterator_traits<RandomIt>::difference_type len,
+                              typename std::iterator_traits<RandomIt>::difference_type child,
+                              Compare comp)
+{	typedef typename std::iterator_traits<RandomIt>::difference_type index_type ;
+    index_type largest = child ;
+    index_type end = len - child >= static_cast<index_type>(Arity) ? child + static_cast<index_type>(Arity) : len ;
+    for(index_type i=child+1; i<end; i++)
+    {	// the mask has all its bits set when the child is larger
+        index_type mask = -static_cast<index_type>(comp(first[largest], first[i])) ;
+        largest ^= (largest ^ i) & mask ;
+    }
+    return largest ;
+}
+
+/*!
+ * \brief Sifts down a value from a hole. The largest children on the path
+ * are moved up one level until the value is not smaller than the largest
+ * child, the value is then moved into the final hole.
+ * \param first the beginning of the heap.
+ * \param len the size of the heap.
+ * \param hole the index of the hole.
+ * \param value the value to place.
+ * \param comp the comparison function.
+ */
+template<size_t Arity, class RandomIt, class Compare>
+void heap_sift_down(RandomIt first,
+                    typename std::iterator_traits<RandomIt>::difference_type len,
+                    typename std::iterator_traits<RandomIt>::difference_type hole,
+                    typename std::iterator_traits<RandomIt>::value_type value,
+                    Compare comp)
+{	while(heap_first_child<Arity>(hole) < len)
+    {	auto child = heap_largest_child<Arity>(first, len, heap_first_child<Arity>(hole), comp) ;
+        if(not comp(value, first[child]))
+        {	break ; }
+        first[hole] = std::move(first[child]) ;
+        hole = child ;
+    }
+    first[hole] = std::move(value) ;
+}
+
+/*!
+ * \brief Sifts down a value from a hole using Floyd's strategy : the hole is
+ * first moved down to a leaf along the path of the largest children, without
+ * comparing them to the value, and the value is then sifted up from there.
+ * This saves comparisons when the value is expected to go back near the
+ * leaves, which is the case when popping elements.
+ * \param first the beginning of the heap.
+ * \param len the size of the heap.
+ * \param hole the index of the hole.
+ * \param value the value to place.
+ * \param comp the comparison function.
+ */
+template<size_t Arity, class RandomIt, class Compare>
+void heap_sift_down_floyd(RandomIt first,
+                          typename std::iterator_traits<RandomIt>::difference_type len,
+                          typename std::iterator_traits<RandomIt>::difference_type hole,
+                          typename std::iterator_traits<RandomIt>::value_type value,
+                          Compare comp)
+{	auto top = hole ;
+    while(heap_first_child<Arity>(hole) < len)
+    {	auto child = heap_largest_child<Arity>(first, len, heap_first_child<Arity>(hole), comp) ;
+        first[hole] = std::move(first[child]) ;
+        hole = child ;
+    }
+    heap_sift_up<Arity>(first, top, hole, std::move(value), comp) ;
+}
+
+
+/*!
+ * \brief Rearranges a range into a heap, in O(n).
+ * \param first the beginning of the range.
+ * \param last the end of the range.
+ * \param comp the comparison function.
+ */
+template<size_t Arity = 2, class RandomIt, class Compare = std::less<>>
+void heap_make(RandomIt first, RandomIt last, Compare comp = Compare())
+{	static_assert(Arity >= 2, "heap arity must be at least 2") ;
+    auto len = last - first ;
+    if(len < 2)
+    {	return ; }
+    // enforce the heap property for all non-leaf nodes
+    for(auto i=heap_parent<Arity>(len-1)+1; i>0; i--)
+    {	heap_sift_down<Arity>(first, len, i-1, std::move(first[i-1]), comp) ; }
+}
+
+/*!
+ * \brief Sorts a range which is a heap, by repeatedly moving its
+ * top to the end of the range.
+ * \param first the beginning of the heap.
+ * \param last the end of the heap.
+ * \param comp the comparison function.
+ */
+template<size_t Arity = 2, class RandomIt, class Compare = std::less<>>
+void heap_sort_heap(RandomIt first, RandomIt last, Compare comp = Compare())
+{	for(auto len=last-first; len>1; len--)
+    {	auto value = std::move(first[len-1]) ;
+        first[len-1] = std::move(first[0]) ;
+        heap_sift_down_floyd<Arity>(first, len-1, 0, std::move(value), comp) ;
+    }
+}
+
+/*!
+ * \brief Sorts a range in place in O(n log(n)) in the worst case,
+ * without any additional memory.
+ * \param first the beginning of the range.
+ * \param last the end of the range.
+ * \param comp the comparison function.
+ */
+template<size_t Arity = 2, class RandomIt, class Compare = std::less<>>
+void heap_sort(RandomIt first, RandomIt last, Compare comp = Compare())
+{	heap_make<Arity>(first, last, comp) ;
+    heap_sort_heap<Arity>(first, last, comp) ;
+}
+
+/*!
+ * \brief Rearranges a range such that [first,middle) contains the
+ * middle-first smallest elements, sorted. The order of the remaining
+ * elements is unspecified. It runs in O(n log(m)) where m is
+ * middle-first, without any additional memory.
+ * \param first the beginning of the range.
+ * \param middle the end of the range to sort.
+ * \param last the end of the range.
+ * \param comp the comparison function.
+ */
+template<size_t Arity = 2, class RandomIt, class Compare = std::less<>>
+void heap_partial_sort(RandomIt first, RandomIt middle, RandomIt last, Compare comp = Compare())
+{	auto len = middle - first ;
+    if(len == 0)
+    {	return ; }
+    heap_make<Arity>(first, middle, comp) ;
+    // the heap holds the smallest elements seen so far, its top is the largest of them
+    for(auto i=middle; i!=last; ++i)
+    {	if(comp(*i, *first))
+        {	auto value = std::move(*i) ;
+            *i = std::move(*first) ;
+            heap_sift_down<Arity>(first, len, 0, std::move(value), comp) ;
+        }
+    }
+    heap_sort_heap<Arity>(first, middle, comp) ;
+}
+
+#endif // HEAP_ALGORITHM_HPP
@@ -0,0 +1,146 @@
+#ifndef HEAP_INSTRUMENTATION_HPP
+#define HEAP_INSTRUMENTATION_HPP
+
+#include <cstddef>
+
+/*
+ * Instrumentation policies of binary_heap. A policy receives the following
+ * calls from the heap :
+ *  - begin_operation(op) and end_operation(op) around each public operation,
+ *  - count_comparison() for each comparison of two elements,
+ *  - count_moves(n) when n elements are moved (a swap being 3 moves),
+ *  - count_sift_level(index) each time a sifted element goes one level
+ *    up or down, index being the index it reached,
+ * and exports its counters through counters(). All the calls of the default
+ * policy, null_instrumentation, are empty such that they compile to nothing.
+ */
+
+
+/*!
+ * \brief The operations reported to the instrumentation policies.
+ */
+enum class heap_operation
+{	build_heap,
+    insert,
+    extract_top,
+    remove,
+    change_priority
+} ;
+
+/*!
+ * \brief The counters exported by the instrumentation policies.
+ */
+struct heap_counters
+{	/*!
+     * \brief The number of operations.
+     */
+    size_t operations = 0 ;
+    /*!
+     * \brief The number of comparisons of elements.
+     */
+    size_t comparisons = 0 ;
+    /*!
+     * \brief The number of element moves.
+     */
+    size_t moves = 0 ;
+    /*!
+     * \brief The total number of levels crossed by the sifted
+     * elements.
+     */
+    size_t sift_levels = 0 ;
+    /*!
+     * \brief The maximum number of levels crossed during a
+     * single operation.
+     */
+    size_t max_sift_levels = 0 ;
+    /*!
+     * \brief The maximum depth reached by a sifted element, the
+     * root being at depth 0.
+     */
+    size_t max_depth = 0 ;
+} ;
+
+
+/*!
+ * \brief The null_instrumentation class is the default instrumentation
+ * policy, which does nothing.
+ */
+class null_instrumentation
+{
+    public:
+        constexpr void begin_operation(heap_operation) {}
+        constexpr void end_operation(heap_operation) {}
+        constexpr void count_comparison() {}
+        constexpr void count_moves(size_t) {}
+        constexpr void count_sift_level(size_t) {}
+
+        /*!
+         * \brief Returns the counters, which are all 0.
+         * \return the counters.
+         */
+        constexpr heap_counters counters() const
+        {	return heap_counters() ; }
+} ;
+
+
+/*!
+ * \brief The counting_instrumentation class is an instrumentation policy
+ * counting the comparisons, the moves and the levels crossed by the sifted
+ * elements.
+ */
+class counting_instrumentation
+{
+    public:
+        constexpr void begin_operation(heap_operation)
+        {	this->_counters.operations++ ;
+            this->_levels = 0 ;
+        }
+
+        constexpr void end_operation(heap_operation)
+        {	if(this->_levels > this->_counters.max_sift_levels)
+            {	this->_counters.max_sift_levels = this->_levels ; }
+        }
+
+        constexpr void count_comparison()
+        {	this->_counters.comparisons++ ; }
+
+        constexpr void count_moves(size_t n)
+        {	this->_counters.moves += n ; }
+
+        constexpr void count_sift_level(size_t index)
+        {	this->_counters.sift_levels++ ;
+            this->_levels++ ;
+            // the depth is floor(log2(index+1))
+            size_t depth = 0 ;
+            for(size_t n=index+1; n>1; n/=2)
+            {	depth++ ; }
+            if(depth > this->_counters.max_depth)
+            {	this->_counters.max_depth = depth ; }
+        }
+
+        /*!
+         * \brief Returns the counters.
+         * \return the counters.
+         */
+        constexpr heap_counters counters() const
+        {	return this->_counters ; }
+
+        /*!
+         * \brief Resets all the counters to 0.
+         */
+        constexpr void reset()
+        {	this->_counters = heap_counters() ; }
+
+    private:
+        /*!
+         * \brief The counters.
+         */
+        heap_counters _counters ;
+        /*!
+         * \brief The number of levels crossed during the
+         * current operation.
+         */
+        size_t _levels = 0 ;
+} ;
+
+#endif // HEAP_INSTRUMENTATION_HPP
@@ -0,0 +1,61 @@
+#ifndef HEAP_KEY_HPP
+#define HEAP_KEY_HPP
+
+#include <type_traits>
+#include <utility> // pair, declval
+
+/*
+ * Key extractors, which give the part of an element the heaps compare (its
+ * priority), such that the payload of an element is never compared, even on
+ * ties. An extractor is a stateless function object taking a const reference
+ * to an element and returning its key.
+ */
+
+
+/*!
+ * \brief The identity_key extractor compares the whole elements.
+ */
+struct identity_key
+{	template<class T>
+    constexpr const T& operator () (const T& value) const
+    {	return value ; }
+} ;
+
+/*!
+ * \brief The first_key extractor compares the first member of
+ * std::pair elements, the second one being the payload.
+ */
+struct first_key
+{	template<class K, class V>
+    constexpr const K& operator () (const std::pair<K,V>& value) const
+    {	return value.first ; }
+} ;
+
+#if __cplusplus >= 201703L
+/*!
+ * \brief The member_key extractor compares a given data member of
+ * record elements, for instance member_key<&record::priority>.
+ */
+template<auto Member>
+struct member_key
+{	template<class T>
+    constexpr const auto& operator () (const T& value) const
+    {	return value.*Member ; }
+} ;
+#endif
+
+
+/*!
+ * \brief The heap_key_traits class gives the key type of the elements of
+ * type T for an extractor, and how the keys are held while comparing them :
+ * fundamental keys (integers, floating points) are copied, which lets them
+ * live in registers, the others are referenced to avoid copying them.
+ */
+template<class KeyOf, class T>
+struct heap_key_traits
+{	typedef typename std::decay<decltype(std::declval<KeyOf>()(std::declval<const T&>()))>::type key_type ;
+    static constexpr bool fundamental = std::is_fundamental<key_type>::value ;
+    typedef typename std::conditional<fundamental, key_type, const key_type&>::type key_reference ;
+} ;
+
+#endif // HEAP_KEY_HPP
@@ -0,0 +1,416 @@
+#ifndef HEAP_TRACE_HPP
+#define HEAP_TRACE_HPP
+
+#include <iostream>
+#include <cstdint>
+#include <cstring>     // memcpy
+#include <vector>
+#include <type_traits>
+#include <utility>     // forward
+#include <stdexcept>
+
+/*
+ * Recording and replay of heap operations. A trace is a binary stream made of
+ * a header followed by one record per operation :
+ *  - header : the magic "HPTR", the format version (1 byte), the key type tag
+ *    (1 byte, see trace_key_tag), the key size (1 byte) and the maximum size
+ *    of the heap (8 bytes),
+ *  - record : the operation (1 byte), then the index for remove and
+ *    change_priority (LEB128 varint), then the key for insert and
+ *    change_priority (the raw bytes of the key).
+ * An insert of an int thus takes 5 bytes, an extraction 1 byte. The integers
+ * are stored in little endian order, the keys in the order of the machine.
+ */
+
+
+/*!
+ * \brief The operations stored in a trace.
+ */
+enum class trace_op : uint8_t
+{	insert,
+    extract_top,
+    remove,
+    change_priority
+} ;
+
+/*!
+ * \brief An operation read from a trace.
+ */
+template<class T>
+struct trace_event
+{	trace_op op ;
+    /*!
+     * \brief The index, for remove and change_priority.
+     */
+    uint64_t index ;
+    /*!
+     * \brief The key, for insert and change_priority.
+     */
+    T key ;
+} ;
+
+/*!
+ * \brief Returns the tag identifying a key type in a trace : 'i' for int,
+ * 'u' for unsigned, 'l' for int64_t, 'q' for uint64_t, 'f' for float, 'd' for
+ * double and '?' for the other types, which can still be traced.
+ * \return the tag of the key type.
+ */
+template<class T>
+constexpr char trace_key_tag()
+{	return std::is_same<T, int>::value ? 'i'
+         : std::is_same<T, unsigned>::value ? 'u'
+         : std::is_same<T, int64_t>::value ? 'l'
+         : std::is_same<T, uint64_t>::value ? 'q'
+         : std::is_same<T, float>::value ? 'f'
+         : std::is_same<T, double>::value ? 'd'
+         : '?' ;
+}
+
+
+/*!
+ * \brief The header of a trace.
+ */
+struct trace_header
+{	/*!
+     * \brief The tag of the key type.
+     */
+    char key_tag ;
+    /*!
+     * \brief The size of the keys, in bytes.
+     */
+    uint8_t key_size ;
+    /*!
+     * \brief The maximum size of the traced heap.
+     */
+    uint64_t capacity ;
+
+    /*!
+     * \brief Writes the header to a stream.
+     * \param stream an output stream of interest.
+     */
+    void write(std::ostream& stream) const
+    {	char bytes[15] = {'H', 'P', 'T', 'R', 1, this->key_tag, static_cast<char>(this->key_size)} ;
+        for(int i=0; i<8; i++)
+        {	bytes[7 + i] = static_cast<char>(this->capacity >> (8*i)) ; }
+        stream.write(bytes, sizeof(bytes)) ;
+    }
+
+    /*!
+     * \brief Reads a header from a stream.
+     * \param stream an input stream of interest.
+     * \return the header.
+     * \throw std::runtime_error if the stream does not hold a trace.
+     */
+    static trace_header read(std::istream& stream)
+    {	unsigned char bytes[15] ;
+        if((not stream.read(reinterpret_cast<char*>(bytes), sizeof(bytes)))
+           or (std::memcmp(bytes, "HPTR", 4) != 0) or (bytes[4] != 1))
+        {	throw std::runtime_error("not a heap trace!") ; }
+        trace_header header ;
+        header.key_tag = static_cast<char>(bytes[5]) ;
+        header.key_size = bytes[6] ;
+        header.capacity = 0 ;
+        for(int i=0; i<8; i++)
+        {	header.capacity |= static_cast<uint64_t>(bytes[7 + i]) << (8*i) ; }
+        return header ;
+    }
+} ;
+
+
+/*!
+ * \brief The trace_writer class writes operations on keys of type T, which
+ * must be trivially copyable, to a trace.
+ */
+template<class T>
+class trace_writer
+{
+    static_assert(std::is_trivially_copyable<T>::value, "trace keys must be trivially copyable") ;
+    static_assert(sizeof(T) < 256, "trace keys must be smaller than 256 bytes") ;
+
+    public:
+        /*!
+         * \brief Writes the header of a trace.
+         * \param stream the stream to write to, opened in binary mode.
+         * \param capacity the maximum size of the traced heap.
+         */
+        trace_writer(std::ostream& stream, uint64_t capacity) ;
+
+        /*!
+         * \brief Writes an operation.
+         * \param op the operation.
+         * \param index the index, for remove and change_priority.
+         * \param key the key, for insert and change_priority.
+         */
+        void write(trace_op op, uint64_t index = 0, const T& key = T()) ;
+
+        /*!
+         * \brief Returns the number of operations written.
+         * \return the number of operations.
+         */
+        size_t operations() const ;
+
+    private:
+        /*!
+         * \brief The stream.
+         */
+        std::ostream& _stream ;
+        /*!
+         * \brief The number of operations written.
+         */
+        size_t _operations ;
+} ;
+
+
+/*!
+ * \brief The trace_reader class reads the operations of a trace.
+ */
+template<class T>
+class trace_reader
+{
+    static_assert(std::is_trivially_copyable<T>::value, "trace keys must be trivially copyable") ;
+
+    public:
+        /*!
+         * \brief Reads the header of a trace.
+         * \param stream the stream to read from, opened in binary mode.
+         * \throw std::runtime_error if the stream does not hold a trace
+         * of keys of type T.
+         */
+        trace_reader(std::istream& stream) ;
+
+        /*!
+         * \brief Reads the next operation.
+         * \param event the operation read.
+         * \return false at the end of the trace.
+         * \throw std::runtime_error if the trace is truncated or corrupted.
+         */
+        bool next(trace_event<T>& event) ;
+
+        /*!
+         * \brief Returns the header of the trace.
+         * \return the header.
+         */
+        const trace_header& header() const ;
+
+    private:
+        /*!
+         * \brief The stream.
+         */
+        std::istream& _stream ;
+        /*!
+         * \brief The header of the trace.
+         */
+        trace_header _header ;
+} ;
+
+
+/*!
+ * \brief The recording_heap class wraps a heap with the interface of
+ * binary_heap, which elements are of type T, and writes every operation which
+ * modifies the heap to a trace, in the order they are made.
+ */
+template<class Heap, class T>
+class recording_heap
+{
+    public:
+        /*!
+         * \brief Constructs the heap with a given maximum size and the
+         * given extra arguments, and writes the header of the trace.
+         * \param sizeMax the maximum size of the heap.
+         * \param trace the stream the trace is written to.
+         * \param args the other arguments of the constructor of the heap.
+         */
+        template<class... Args>
+        recording_heap(size_t sizeMax, std::ostream& trace, Args&&... args)
+            : _heap(sizeMax, std::forward<Args>(args)...), _writer(trace, sizeMax)
+        {}
+
+        T top() const
+        {	return this->_heap.top() ; }
+
+        T extract_top()
+        {	this->_writer.write(trace_op::extract_top) ;
+            return this->_heap.extract_top() ;
+        }
+
+        void insert(T value)
+        {	this->_writer.write(trace_op::insert, 0, value) ;
+            this->_heap.insert(value) ;
+        }
+
+        void remove(int index)
+        {	this->_writer.write(trace_op::remove, index) ;
+            this->_heap.remove(index) ;
+        }
+
+        void change_priority(int index, T priority)
+        {	this->_writer.write(trace_op::change_priority, index, priority) ;
+            this->_heap.change_priority(index, priority) ;
+        }
+
+        int find(T value)
+        {	return this->_heap.find(value) ; }
+
+        bool empty() const
+        {	return this->_heap.empty() ; }
+
+        bool full() const
+        {	return this->_heap.full() ; }
+
+        size_t size() const
+        {	return this->_heap.size() ; }
+
+        /*!
+         * \brief Returns the wrapped heap.
+         * \return the wrapped heap.
+         */
+        const Heap& heap() const
+        {	return this->_heap ; }
+
+    private:
+        /*!
+         * \brief The wrapped heap.
+         */
+        Heap _heap ;
+        /*!
+         * \brief The writer of the trace.
+         */
+        trace_writer<T> _writer ;
+} ;
+
+
+/*!
+ * \brief Reads all the operations of a trace, such that they can be replayed
+ * without parsing costs.
+ * \param reader the reader of the trace.
+ * \return the operations.
+ */
+template<class T>
+std::vector<trace_event<T>> read_trace(trace_reader<T>& reader)
+{	std::vector<trace_event<T>> events ;
+    trace_event<T> event ;
+    while(reader.next(event))
+    {	events.push_back(event) ; }
+    return events ;
+}
+
+/*!
+ * \brief Replays operations on a heap with the interface of binary_heap. The
+ * indices are positions in the traced heap, which may not hold the same
+ * values in another kind of heap : they are taken modulo the current size,
+ * such that any heap can replay any trace. The insertions into a full heap
+ * and the operations on an empty heap are skipped.
+ * \param events the operations.
+ * \param heap the heap to replay the operations on.
+ * \return the number of operations replayed.
+ */
+template<class T, class Heap>
+size_t replay_trace(const std::vector<trace_event<T>>& events, Heap& heap)
+{	size_t operations = 0 ;
+    for(const trace_event<T>& event : events)
+    {	switch(event.op)
+        {	case trace_op::insert :
+                if(heap.full())
+                {	continue ; }
+                heap.insert(event.key) ;
+                break ;
+            case trace_op::extract_top :
+                if(heap.empty())
+                {	continue ; }
+                heap.extract_top() ;
+                break ;
+            case trace_op::remove :
+                if(heap.empty())
+                {	continue ; }
+                heap.remove(static_cast<int>(event.index % heap.size())) ;
+                break ;
+            case trace_op::change_priority :
+                if(heap.empty())
+                {	continue ; }
+                heap.change_priority(static_cast<int>(event.index % heap.size()), event.key) ;
+                break ;
+        }
+        operations++ ;
+    }
+    return operations ;
+}
+
+
+template<class T>
+trace_writer<T>::trace_writer(std::ostream& stream, uint64_t capacity)
+    : _stream(stream), _operations(0)
+{	trace_header header{trace_key_tag<T>(), static_cast<uint8_t>(sizeof(T)), capacity} ;
+    header.write(stream) ;
+}
+
+template<class T>
+void trace_writer<T>::write(trace_op op, uint64_t index, const T& key)
+{	char bytes[1 + 10 + sizeof(T)] ;
+    size_t n = 0 ;
+    bytes[n++] = static_cast<char>(op) ;
+    if((op == trace_op::remove) or (op == trace_op::change_priority))
+    {	// LEB128 : 7 bits per byte, the high bit telling whether more bytes follow
+        do
+        {	unsigned char byte = index & 0x7f ;
+            index >>= 7 ;
+            bytes[n++] = static_cast<char>(index != 0 ? byte | 0x80 : byte) ;
+        }
+        while(index != 0) ;
+    }
+    if((op == trace_op::insert) or (op == trace_op::change_priority))
+    {	std::memcpy(bytes + n, &key, sizeof(T)) ;
+        n += sizeof(T) ;
+    }
+    this->_stream.write(bytes, n) ;
+    this->_operations++ ;
+}
+
+template<class T>
+size_t trace_writer<T>::operations() const
+{	return this->_operations ; }
+
+
+template<class T>
+trace_reader<T>::trace_reader(std::istream& stream)
+    : _stream(stream), _header(trace_header::read(stream))
+{	if(this->_header.key_size != sizeof(T))
+    {	throw std::runtime_error("the trace keys have another type!") ; }
+    if((this->_header.key_tag != trace_key_tag<T>()) and (trace_key_tag<T>() != '?'))
+    {	throw std::runtime_error("the trace keys have another type!") ; }
+}
+
+template<class T>
+bool trace_reader<T>::next(trace_event<T>& event)
+{	int op = this->_stream.get() ;
+    if(op == std::char_traits<char>::eof())
+    {	return false ; }
+    if(op > static_cast<int>(trace_op::change_priority))
+    {	throw std::runtime_error("corrupted heap trace!") ; }
+    event.op = static_cast<trace_op>(op) ;
+    event.index = 0 ;
+    if((event.op == trace_op::remove) or (event.op == trace_op::change_priority))
+    {	int byte ;
+        int shift = 0 ;
+        do
+        {	byte = this->_stream.get() ;
+            if((byte == std::char_traits<char>::eof()) or (shift > 63))
+            {	throw std::runtime_error("truncated heap trace!") ; }
+            event.index |= static_cast<uint64_t>(byte & 0x7f) << shift ;
+            shift += 7 ;
+        }
+        while(byte & 0x80) ;
+    }
+    if((event.op == trace_op::insert) or (event.op == trace_op::change_priority))
+    {	char bytes[sizeof(T)] ;
+        if(not this->_stream.read(bytes, sizeof(T)))
+        {	throw std::runtime_error("truncated heap trace!") ; }
+        std::memcpy(&event.key, bytes, sizeof(T)) ;
+    }
+    return true ;
+}
+
+template<class T>
+const trace_header& trace_reader<T>::header() const
+{	return this->_header ; }
+
+#endif // HEAP_TRACE_HPP
@@ -0,0 +1,294 @@
+#ifndef INDIRECT_HEAP_HPP
+#define INDIRECT_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <memory>     // allocator
+#include <functional> // less
+#include <cstdint>
+#include <stdexcept>
+#include "heap_algorithm.hpp"
+#include "key_encoding.hpp"
+
+
+/*!
+ * \brief The indirect_heap class implements a maximum Arity-ary heap of
+ * references to elements stored by the caller, for elements which are too
+ * large to be moved by the sifts. Each entry is a 64 bits word : the high
+ * bits hold the order-preserving code of the key (see key_encoding.hpp) and
+ * the low bits the index of the element in the caller's array. The sifts then
+ * compare entries with a single integer comparison and move 8 bytes.
+ * Only the 16 and 32 bits keys are supported (the 64 bits ones would leave
+ * no bits for the index) : the index has 64 - key_encoding<K>::bits bits,
+ * 32 bits for 32 bits keys, 48 bits for 16 bits keys. Elements of equal keys
+ * come out by decreasing index.
+ * The positions taken by remove() and change_priority() are positions in
+ * the heap, as returned by find().
+ */
+template<class K, size_t Arity = 4, class Allocator = std::allocator<std::uint64_t>>
+class indirect_heap
+{
+    public:
+        typedef key_encoding<K> encoding_type ;
+
+        indirect_heap() = delete ;
+        /*!
+         * \brief Constructs an empty heap with a given
+         * maximum size.
+         * \param sizeMax the maximum size of the heap.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        indirect_heap(size_t sizeMax, const Allocator& allocator = Allocator()) ;
+        /*!
+         * \brief Constructs a heap of the elements of a caller's
+         * array from their keys, in O(n), element i having index i.
+         * The maximum size is set to the number of keys.
+         * \param keys the keys of the elements.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        indirect_heap(const std::vector<K>& keys, const Allocator& allocator = Allocator()) ;
+
+        // methods
+        /*!
+         * \brief Returns the index of the element of maximum key.
+         * \return the index of the maximum element.
+         */
+        size_t top() const ;
+        /*!
+         * \brief Returns the maximum key of the heap.
+         * \return the maximum key.
+         */
+        K top_key() const ;
+        /*!
+         * \brief Removes the element of maximum key and returns
+         * its index.
+         * \return the index of the maximum element.
+         */
+        size_t extract_top() ;
+
+        /*!
+         * \brief Insert the element of a given index with a
+         * given key.
+         * \param key the key of the element.
+         * \param index the index of the element in the caller's
+         * array.
+         * \throw std::runtime_error if the heap is full or if the
+         * index does not fit in the entry.
+         */
+        void insert(K key, size_t index) ;
+        /*!
+         * \brief Removes the entry at the given position.
+         * \param position the position of the entry to remove.
+         */
+        void remove(int position) ;
+        /*!
+         * \brief Changes the key of the entry at the given
+         * position.
+         * \param position the position of the entry to change.
+         * \param key the new key.
+         */
+        void change_priority(int position, K key) ;
+
+        /*!
+         * \brief Searches the heap for the element of the given
+         * index and returns its position. If it could not be found,
+         * -1 is returned. This method is not time efficient (O(n)).
+         * \param index the index of the element to find.
+         * \return the position of the element if it has been found,
+         * -1 otherwise.
+         */
+        int find(size_t index) const ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * an indirect heap to a stream, as key:index pairs.
+         * \param stream an output stream of interest.
+         * \param h an indirect heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U, size_t D, class A>
+        friend std::ostream& operator << (std::ostream& stream, const indirect_heap<U,D,A>& h) ;
+
+    private:
+        typedef std::ptrdiff_t index_type ;
+        typedef std::less<std::uint64_t> compare_type ; // change to std::greater for min heap
+
+        static constexpr unsigned index_bits = 64 - encoding_type::bits ;
+        static constexpr std::uint64_t index_mask = (std::uint64_t(1) << index_bits) - 1 ;
+        static_assert(encoding_type::bits <= 32, "indirect_heap keys must have at most 32 bits") ;
+
+        // methods
+        /*!
+         * \brief Packs a key and an index in an entry.
+         * \param key the key of interest.
+         * \param index the index of interest.
+         * \return the entry.
+         * \throw std::runtime_error if the index does not fit in the entry.
+         */
+        static std::uint64_t pack(K key, size_t index) ;
+        /*!
+         * \brief Returns the key of an entry.
+         * \param entry the entry of interest.
+         * \return the key.
+         */
+        static K key(std::uint64_t entry) ;
+        /*!
+         * \brief Returns the index of an entry.
+         * \param entry the entry of interest.
+         * \return the index.
+         */
+        static size_t index(std::uint64_t entry) ;
+
+        // fields
+        /*!
+         * \brief The maximum size of the heap.
+         */
+        size_t _sizeMax ;
+        /*!
+         * \brief The current size of the heap.
+         */
+        size_t _size ;
+        /*!
+         * \brief The vector storing the entries.
+         */
+        std::vector<std::uint64_t, Allocator> _heap ;
+} ;
+
+
+template<class K, size_t Arity, class Allocator>
+indirect_heap<K,Arity,Allocator>::indirect_heap(size_t sizeMax, const Allocator& allocator)
+    : _sizeMax(sizeMax), _size(0), _heap(sizeMax, allocator)
+{}
+
+template<class K, size_t Arity, class Allocator>
+indirect_heap<K,Arity,Allocator>::indirect_heap(const std::vector<K>& keys, const Allocator& allocator)
+    : _sizeMax(keys.size()), _size(keys.size()), _heap(allocator)
+{	this->_heap.reserve(keys.size()) ;
+    for(size_t i=0; i<keys.size(); i++)
+    {	this->_heap.push_back(pack(keys[i], i)) ; }
+    heap_make<Arity>(this->_heap.begin(), this->_heap.end(), compare_type()) ;
+}
+
+
+template<class K, size_t Arity, class Allocator>
+size_t indirect_heap<K,Arity,Allocator>::top() const
+{	return index(this->_heap[0]) ; }
+
+template<class K, size_t Arity, class Allocator>
+K indirect_heap<K,Arity,Allocator>::top_key() const
+{	return key(this->_heap[0]) ; }
+
+template<class K, size_t Arity, class Allocator>
+size_t indirect_heap<K,Arity,Allocator>::extract_top()
+{	std::uint64_t top = this->_heap[0] ;
+    this->_size-- ;
+    if(this->size() > 0)
+    {	heap_sift_down_floyd<Arity>(this->_heap.begin(), this->size(), 0, this->_heap[this->size()], compare_type()) ; }
+    return index(top) ;
+}
+
+
+template<class K, size_t Arity, class Allocator>
+void indirect_heap<K,Arity,Allocator>::insert(K key, size_t index)
+{	if(this->full())
+    {	throw std::runtime_error("indirect_heap is full!") ; }
+
+    std::uint64_t entry = pack(key, index) ;
+    index_type hole = this->size() ;
+    this->_size++ ;
+    heap_sift_up<Arity>(this->_heap.begin(), 0, hole, entry, compare_type()) ;
+}
+
+template<class K, size_t Arity, class Allocator>
+void indirect_heap<K,Arity,Allocator>::remove(int position)
+{	// move the hole to the top, as if the entry had the maximum priority
+    index_type hole = position ;
+    while(hole > 0)
+    {	index_type parent = heap_parent<Arity>(hole) ;
+        this->_heap[hole] = this->_heap[parent] ;
+        hole = parent ;
+    }
+    this->_size-- ;
+    if(this->size() > 0)
+    {	heap_sift_down_floyd<Arity>(this->_heap.begin(), this->size(), 0, this->_heap[this->size()], compare_type()) ; }
+}
+
+
+template<class K, size_t Arity, class Allocator>
+void indirect_heap<K,Arity,Allocator>::change_priority(int position, K key)
+{	std::uint64_t entry = pack(key, index(this->_heap[position])) ;
+    if(compare_type()(this->_heap[position], entry))
+    {	heap_sift_up<Arity>(this->_heap.begin(), 0, position, entry, compare_type()) ; }
+    else
+    {	heap_sift_down<Arity>(this->_heap.begin(), this->size(), position, entry, compare_type()) ; }
+}
+
+
+template<class K, size_t Arity, class Allocator>
+int indirect_heap<K,Arity,Allocator>::find(size_t index) const
+{	for(size_t i=0; i<this->size(); i++)
+    {	if(indirect_heap::index(this->_heap[i]) == index)
+        {	return i ; }
+    }
+    return -1 ;
+}
+
+
+template<class K, size_t Arity, class Allocator>
+bool indirect_heap<K,Arity,Allocator>::empty() const
+{	return this->size() == 0 ; }
+
+template<class K, size_t Arity, class Allocator>
+bool indirect_heap<K,Arity,Allocator>::full() const
+{	return this->size() == this->_sizeMax ; }
+
+template<class K, size_t Arity, class Allocator>
+size_t indirect_heap<K,Arity,Allocator>::size() const
+{	return this->_size ; }
+
+
+template<class K, size_t Arity, class Allocator>
+std::uint64_t indirect_heap<K,Arity,Allocator>::pack(K key, size_t index)
+{	if(static_cast<std::uint64_t>(index) > index_mask)
+    {	throw std::runtime_error("indirect_heap index is too large!") ; }
+    return (static_cast<std::uint64_t>(encoding_type::encode(key)) << index_bits) | index ;
+}
+
+template<class K, size_t Arity, class Allocator>
+K indirect_heap<K,Arity,Allocator>::key(std::uint64_t entry)
+{	return encoding_type::decode(static_cast<typename encoding_type::code_type>(entry >> index_bits)) ; }
+
+template<class K, size_t Arity, class Allocator>
+size_t indirect_heap<K,Arity,Allocator>::index(std::uint64_t entry)
+{	return static_cast<size_t>(entry & index_mask) ; }
+
+
+template<class K, size_t Arity, class Allocator>
+std::ostream& operator << (std::ostream& stream, const indirect_heap<K,Arity,Allocator>& h)
+{	for(size_t i=0; i<h.size(); i++)
+    {	stream << +indirect_heap<K,Arity,Allocator>::key(h._heap[i]) << ':'
+               << indirect_heap<K,Arity,Allocator>::index(h._heap[i]) << ' ' ;
+    }
+    return stream ;
+}
+
+#endif // INDIRECT_HEAP_HPP
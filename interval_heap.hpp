@@ -0,0 +1,416 @@
+#ifndef INTERVAL_HEAP_HPP
+#define INTERVAL_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <memory>    // allocator
+#include <algorithm> // swap
+#include <utility>   // move
+#include <stdexcept>
+
+
+/*!
+ * \brief The interval_heap class implements an interval heap, a double-ended
+ * priority queue giving access to both its minimum and its maximum values,
+ * with the same interface as min_max_heap.
+ * Each node of the tree holds a pair of elements (a, b), with a <= b, that is
+ * an interval. The interval of a node contains the intervals of its children,
+ * such that the minimum is the lower bound and the maximum the upper bound of
+ * the root. The last node may hold a single element, which then belongs to the
+ * interval of its parent.
+ * Node i is stored at indices 2i (lower bound) and 2i+1 (upper bound) and the
+ * children of node i are nodes 2i+1 and 2i+2. The lower bounds form a minimum
+ * heap and the upper bounds a maximum heap, each of half the size of the
+ * whole heap.
+ */
+template<class T, class Allocator = std::allocator<T>>
+class interval_heap
+{
+    public:
+        interval_heap() = delete ;
+        /*!
+         * \brief Constructs an empty interval heap with a given
+         * maximum size.
+         * \param sizeMax the maximum size of the heap.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        interval_heap(size_t sizeMax, const Allocator& allocator = Allocator()) ;
+        /*!
+         * \brief Constructs an interval heap from a given vector.
+         * The maximum size is set to the vector size.
+         * \param v a vector to construct the interval heap from.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        interval_heap(const std::vector<T>& v, const Allocator& allocator = Allocator()) ;
+
+        // methods
+        /*!
+         * \brief Returns the maximum value of the heap, in O(1).
+         * \return the maximum value.
+         */
+        T top_max() const ;
+        /*!
+         * \brief Returns the minimum value of the heap, in O(1).
+         * \return the minimum value.
+         */
+        T top_min() const ;
+        /*!
+         * \brief Removes and return the maximum value of the
+         * heap, in O(log(n)).
+         * \return the maximum value.
+         */
+        T extract_max() ;
+        /*!
+         * \brief Removes and return the minimum value of the
+         * heap, in O(log(n)).
+         * \return the minimum value.
+         */
+        T extract_min() ;
+
+        /*!
+         * \brief Insert a given value within the heap, in O(log(n)).
+         * \param value a value to insert.
+         * \throw std::runtime_error if the heap is full.
+         */
+        void insert(T value) ;
+        /*!
+         * \brief Removes the value at the given index, in O(log(n)).
+         * \param index the index of the value to remove.
+         */
+        void remove(int index) ;
+
+        /*!
+         * \brief Searches the heap for the given value and returns
+         * its index. If it could not be found, -1 is returned. This
+         * method is not time efficient (O(n)).
+         * \param value a value to find in the heap.
+         * \return the index of the value if it has been found,
+         * -1 otherwise.
+         */
+        int find(T value) const ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * an interval heap to a stream.
+         * \param stream an output stream of interest.
+         * \param h an interval heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U, class A>
+        friend std::ostream& operator << (std::ostream& stream, const interval_heap<U,A>& h) ;
+
+    private:
+        // methods
+        /*!
+         * \brief Sifts up the lower bound located at a given index
+         * along the lower bounds of the ancestors.
+         * \param index the index of the element to sift up.
+         */
+        void sift_up_min(size_t index) ;
+        /*!
+         * \brief Sifts up the upper bound located at a given index
+         * along the upper bounds of the ancestors.
+         * \param index the index of the element to sift up.
+         */
+        void sift_up_max(size_t index) ;
+        /*!
+         * \brief Sifts down the lower bound located at a given index
+         * along the lower bounds of the descendants.
+         * \param index the index of the element to sift down.
+         */
+        void sift_down_min(size_t index) ;
+        /*!
+         * \brief Sifts down the upper bound located at a given index
+         * along the upper bounds of the descendants.
+         * \param index the index of the element to sift down.
+         */
+        void sift_down_max(size_t index) ;
+        /*!
+         * \brief Restores the heap after the value at the given
+         * index has been replaced by an arbitrary value.
+         * \param index the index of the value.
+         */
+        void fix(size_t index) ;
+
+        /*!
+         * \brief Returns the index of the node of the parent of
+         * the node holding the element at the given index.
+         * \param index the index of the element of interest.
+         * \return the index of the parent node.
+         */
+        static size_t parent(size_t index) ;
+        /*!
+         * \brief Returns the index of the upper bound of a node, or
+         * of its single element if it holds only one.
+         * \param node the index of the node of interest.
+         * \return the index of the upper bound.
+         */
+        size_t upper(size_t node) const ;
+
+        // fields
+        /*!
+         * \brief The maximum size of the heap.
+         */
+        size_t _sizeMax ;
+        /*!
+         * \brief The current size of the heap.
+         */
+        size_t _size ;
+        /*!
+         * \brief The vector storing the heap.
+         */
+        std::vector<T, Allocator> _heap ;
+} ;
+
+
+template<class T, class Allocator>
+interval_heap<T,Allocator>::interval_heap(size_t sizeMax, const Allocator& allocator)
+    : _sizeMax(sizeMax), _size(0), _heap(sizeMax, allocator)
+{}
+
+template<class T, class Allocator>
+interval_heap<T,Allocator>::interval_heap(const std::vector<T>& v, const Allocator& allocator)
+    : _sizeMax(v.size()), _size(v.size()), _heap(v.begin(), v.end(), allocator)
+{	// enforce the interval heap property for all nodes, from the last one
+    for(size_t node=(this->size()+1)/2; node>0; node--)
+    {	size_t lower = 2*(node-1) ;
+        if(lower + 1 < this->size())
+        {	if(this->_heap[lower+1] < this->_heap[lower])
+            {	std::swap(this->_heap[lower], this->_heap[lower+1]) ; }
+            this->sift_down_max(lower+1) ;
+        }
+        this->sift_down_min(lower) ;
+    }
+}
+
+
+template<class T, class Allocator>
+T interval_heap<T,Allocator>::top_max() const
+{	return this->_heap[this->upper(0)] ; }
+
+template<class T, class Allocator>
+T interval_heap<T,Allocator>::top_min() const
+{	return this->_heap[0] ; }
+
+template<class T, class Allocator>
+T interval_heap<T,Allocator>::extract_max()
+{	size_t index = this->upper(0) ;
+    T top = this->_heap[index] ;
+    this->remove(index) ;
+    return top ;
+}
+
+template<class T, class Allocator>
+T interval_heap<T,Allocator>::extract_min()
+{	T top = this->_heap[0] ;
+    this->remove(0) ;
+    return top ;
+}
+
+
+template<class T, class Allocator>
+void interval_heap<T,Allocator>::insert(T value)
+{	if(this->full())
+    {	throw std::runtime_error("interval_heap is full!") ; }
+
+    size_t index = this->size() ;
+    this->_size++ ;
+    this->_heap[index] = std::move(value) ;
+    if(index % 2 == 1)
+    {	// the node now holds two elements
+        if(this->_heap[index] < this->_heap[index-1])
+        {	std::swap(this->_heap[index], this->_heap[index-1]) ;
+            this->sift_up_min(index-1) ;
+        }
+        else
+        {	this->sift_up_max(index) ; }
+    }
+    else if(index > 0)
+    {	// a new node holding a single element, which must belong to its parent interval
+        size_t p = parent(index) ;
+        if(this->_heap[index] < this->_heap[2*p])
+        {	this->sift_up_min(index) ; }
+        else
+        {	this->sift_up_max(index) ; }
+    }
+}
+
+template<class T, class Allocator>
+void interval_heap<T,Allocator>::remove(int index)
+{	size_t i = index ;
+    this->_size-- ;
+    if(i == this->size())
+    {	return ; }
+    this->_heap[i] = std::move(this->_heap[this->size()]) ;
+    this->fix(i) ;
+}
+
+
+template<class T, class Allocator>
+int interval_heap<T,Allocator>::find(T value) const
+{   for(size_t i=0; i<this->size(); i++)
+    {   if(this->_heap[i] == value)
+        {   return i ; }
+    }
+    return -1 ;
+}
+
+
+template<class T, class Allocator>
+bool interval_heap<T,Allocator>::empty() const
+{	return this->size() == 0 ; }
+
+template<class T, class Allocator>
+bool interval_heap<T,Allocator>::full() const
+{	return this->size() == this->_sizeMax ; }
+
+template<class T, class Allocator>
+size_t interval_heap<T,Allocator>::size() const
+{	return this->_size ; }
+
+
+template<class T, class Allocator>
+void interval_heap<T,Allocator>::sift_up_min(size_t index)
+{	while(index > 1)
+    {	size_t p = 2*parent(index) ;
+        if(not (this->_heap[index] < this->_heap[p]))
+        {	break ; }
+        std::swap(this->_heap[index], this->_heap[p]) ;
+        index = p ;
+    }
+}
+
+template<class T, class Allocator>
+void interval_heap<T,Allocator>::sift_up_max(size_t index)
+{	while(index > 1)
+    {	size_t p = 2*parent(index) + 1 ;
+        if(not (this->_heap[p] < this->_heap[index]))
+        {	break ; }
+        std::swap(this->_heap[index], this->_heap[p]) ;
+        index = p ;
+    }
+}
+
+template<class T, class Allocator>
+void interval_heap<T,Allocator>::sift_down_min(size_t index)
+{	size_t node = index / 2 ;
+    while(true)
+    {	size_t lower = 2*node ;
+        // the lower bound must not exceed the upper bound
+        if((lower + 1 < this->size()) and (this->_heap[lower+1] < this->_heap[lower]))
+        {	std::swap(this->_heap[lower], this->_heap[lower+1]) ; }
+        // the child with the smallest lower bound
+        size_t child = 2*lower + 2 ;
+        if(child >= this->size())
+        {	break ; }
+        if((child + 2 < this->size()) and (this->_heap[child+2] < this->_heap[child]))
+        {	child += 2 ; }
+        if(not (this->_heap[child] < this->_heap[lower]))
+        {	break ; }
+        std::swap(this->_heap[lower], this->_heap[child]) ;
+        node = child / 2 ;
+    }
+}
+
+template<class T, class Allocator>
+void interval_heap<T,Allocator>::sift_down_max(size_t index)
+{	size_t node = index / 2 ;
+    while(true)
+    {	size_t upper = this->upper(node) ;
+        // the upper bound must not be below the lower bound
+        if(this->_heap[upper] < this->_heap[2*node])
+        {	std::swap(this->_heap[upper], this->_heap[2*node]) ; }
+        // the child with the largest upper bound
+        size_t left = 2*node + 1 ;
+        if(2*left >= this->size())
+        {	break ; }
+        size_t child = this->upper(left) ;
+        if(2*(left+1) < this->size())
+        {	size_t right = this->upper(left+1) ;
+            if(this->_heap[child] < this->_heap[right])
+            {	child = right ; }
+        }
+        if(not (this->_heap[upper] < this->_heap[child]))
+        {	break ; }
+        std::swap(this->_heap[upper], this->_heap[child]) ;
+        node = child / 2 ;
+    }
+}
+
+template<class T, class Allocator>
+void interval_heap<T,Allocator>::fix(size_t index)
+{	if(index % 2 == 0)
+    {	// a lower bound
+        if((index + 1 < this->size()) and (this->_heap[index+1] < this->_heap[index]))
+        {	// the value is the new upper bound, the former upper bound
+            // is the new lower bound and may have to go down
+            std::swap(this->_heap[index], this->_heap[index+1]) ;
+            this->sift_down_min(index) ;
+            this->sift_up_max(index+1) ;
+        }
+        else if((index > 1) and (this->_heap[index] < this->_heap[2*parent(index)]))
+        {	this->sift_up_min(index) ; }
+        else if((index > 1) and (index + 1 >= this->size()) and (this->_heap[2*parent(index)+1] < this->_heap[index]))
+        {	// a single element, which is an upper bound as well
+            this->sift_up_max(index) ;
+        }
+        else
+        {	this->sift_down_min(index) ; }
+    }
+    else
+    {	// an upper bound
+        if(this->_heap[index] < this->_heap[index-1])
+        {	// the value is the new lower bound, the former lower bound
+            // is the new upper bound and may have to go down
+            std::swap(this->_heap[index], this->_heap[index-1]) ;
+            this->sift_down_max(index) ;
+            this->sift_up_min(index-1) ;
+        }
+        else if((index > 1) and (this->_heap[2*parent(index)+1] < this->_heap[index]))
+        {	this->sift_up_max(index) ; }
+        else
+        {	this->sift_down_max(index) ; }
+    }
+}
+
+
+template<class T, class Allocator>
+size_t interval_heap<T,Allocator>::parent(size_t index)
+{	return ((index / 2) - 1) / 2 ; }
+
+template<class T, class Allocator>
+size_t interval_heap<T,Allocator>::upper(size_t node) const
+{	return 2*node + 1 < this->size() ? 2*node + 1 : 2*node ; }
+
+
+template<class T, class Allocator>
+std::ostream& operator << (std::ostream& stream, const interval_heap<T,Allocator>& h)
+{	for(size_t i=0; i<h.size(); i+=2)
+    {	stream << '[' << h._heap[i] ;
+        if(i + 1 < h.size())
+        {	stream << ' ' << h._heap[i+1] ; }
+        stream << ']' << ' ' ;
+    }
+    return stream ;
+}
+
+#endif // INTERVAL_HEAP_HPP
@@ -0,0 +1,121 @@
+#ifndef KEY_ENCODING_HPP
+#define KEY_ENCODING_HPP
+
+#include <cstdint>
+#include <cstring> // memcpy
+
+/*
+ * Order-preserving encodings of keys to unsigned integers : a < b if and only
+ * if encode(a) < encode(b), such that a heap can compare the codes with a
+ * single integer comparison, or pack them with other data in a word.
+ * Each specialization of key_encoding gives the code type, its number of
+ * significant bits, and the encode and decode functions.
+ */
+
+
+/*!
+ * \brief The key_encoding class maps the keys of type K to unsigned codes
+ * in the same order. It is specialized for the supported key types.
+ */
+template<class K>
+struct key_encoding ;
+
+/*!
+ * \brief Unsigned 32 bits keys are their own codes.
+ */
+template<>
+struct key_encoding<std::uint32_t>
+{	typedef std::uint32_t code_type ;
+    static constexpr unsigned bits = 32 ;
+    static constexpr code_type encode(std::uint32_t key) { return key ; }
+    static constexpr std::uint32_t decode(code_type code) { return code ; }
+} ;
+
+/*!
+ * \brief Signed 32 bits keys have their sign bit flipped, such that the
+ * negative keys come first.
+ */
+template<>
+struct key_encoding<std::int32_t>
+{	typedef std::uint32_t code_type ;
+    static constexpr unsigned bits = 32 ;
+    static constexpr code_type encode(std::int32_t key)
+    {	return static_cast<code_type>(key) ^ 0x80000000u ; }
+    static constexpr std::int32_t decode(code_type code)
+    {	return static_cast<std::int32_t>(code ^ 0x80000000u) ; }
+} ;
+
+/*!
+ * \brief Unsigned 16 bits keys are their own codes.
+ */
+template<>
+struct key_encoding<std::uint16_t>
+{	typedef std::uint16_t code_type ;
+    static constexpr unsigned bits = 16 ;
+    static constexpr code_type encode(std::uint16_t key) { return key ; }
+    static constexpr std::uint16_t decode(code_type code) { return code ; }
+} ;
+
+/*!
+ * \brief Signed 16 bits keys have their sign bit flipped.
+ */
+template<>
+struct key_encoding<std::int16_t>
+{	typedef std::uint16_t code_type ;
+    static constexpr unsigned bits = 16 ;
+    static constexpr code_type encode(std::int16_t key)
+    {	return static_cast<code_type>(static_cast<code_type>(key) ^ 0x8000u) ; }
+    static constexpr std::int16_t decode(code_type code)
+    {	return static_cast<std::int16_t>(code ^ 0x8000u) ; }
+} ;
+
+/*!
+ * \brief IEEE-754 single precision keys : the sign bit of the positive keys
+ * is set and all the bits of the negative keys are flipped, which reverses
+ * their order. The codes follow the totalOrder predicate of IEEE-754 : -0
+ * comes right before +0, and the NaNs come after +infinity, or before
+ * -infinity when their sign bit is set, ordered by payload. Unlike the
+ * floating point comparisons, this is a total order, such that a heap of
+ * codes stays consistent with NaN keys.
+ */
+template<>
+struct key_encoding<float>
+{	typedef std::uint32_t code_type ;
+    static constexpr unsigned bits = 32 ;
+    static code_type encode(float key)
+    {	code_type code ;
+        std::memcpy(&code, &key, sizeof(code)) ;
+        return (code & 0x80000000u) ? ~code : code | 0x80000000u ;
+    }
+    static float decode(code_type code)
+    {	code = (code & 0x80000000u) ? code & 0x7fffffffu : ~code ;
+        float key ;
+        std::memcpy(&key, &code, sizeof(key)) ;
+        return key ;
+    }
+} ;
+
+/*!
+ * \brief IEEE-754 double precision keys, encoded as the single precision
+ * ones.
+ */
+template<>
+struct key_encoding<double>
+{	typedef std::uint64_t code_type ;
+    static constexpr unsigned bits = 64 ;
+    static code_type encode(double key)
+    {	code_type code ;
+        std::memcpy(&code, &key, sizeof(code)) ;
+        const code_type sign = code_type(1) << 63 ;
+        return (code & sign) ? ~code : code | sign ;
+    }
+    static double decode(code_type code)
+    {	const code_type sign = code_type(1) << 63 ;
+        code = (code & sign) ? code & ~sign : ~code ;
+        double key ;
+        std::memcpy(&key, &code, sizeof(key)) ;
+        return key ;
+    }
+} ;
+
+#endif // KEY_ENCODING_HPP
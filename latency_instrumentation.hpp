@@ -0,0 +1,300 @@
+#ifndef LATENCY_INSTRUMENTATION_HPP
+#define LATENCY_INSTRUMENTATION_HPP
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <chrono>
+#include "heap_instrumentation.hpp"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // __rdtsc
+#endif
+
+
+/*!
+ * \brief The latency_clock class reads the time stamp counter of the
+ * processor, or the steady clock (in nanoseconds) on the other architectures.
+ */
+class latency_clock
+{
+    public:
+        /*!
+         * \brief Returns the current time, in ticks.
+         * \return the current time.
+         */
+        static uint64_t now()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc() ;
+#else
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch()).count() ;
+#endif
+        }
+
+        /*!
+         * \brief Returns the number of ticks per nanosecond, measured
+         * once against the steady clock over 10 milliseconds.
+         * \return the number of ticks per nanosecond.
+         */
+        static double ticks_per_ns()
+        {	static const double ratio = calibrate() ;
+            return ratio ;
+        }
+
+    private:
+        static double calibrate()
+        {	auto start = std::chrono::steady_clock::now() ;
+            uint64_t ticks = now() ;
+            auto end = start ;
+            do
+            {	end = std::chrono::steady_clock::now() ; }
+            while(end - start < std::chrono::milliseconds(10)) ;
+            ticks = now() - ticks ;
+            double ns = std::chrono::duration<double, std::nano>(end - start).count() ;
+            return ticks / ns ;
+        }
+} ;
+
+
+/*!
+ * \brief The latency_histogram class records values (latencies in ticks) in a
+ * fixed memory log-linear histogram, as HdrHistogram does : the values below
+ * 2^SubBits are recorded exactly and each power of two above is split into
+ * 2^SubBits buckets, such that the relative error of a percentile is at most
+ * 2^-SubBits (about 3% with the default 5 bits). The values of 2^32 ticks or
+ * more are counted in the last bucket, the maximum being kept exactly.
+ */
+template<unsigned SubBits = 5>
+class latency_histogram
+{
+    public:
+        /*!
+         * \brief The number of buckets.
+         */
+        static constexpr size_t buckets = (32 - SubBits + 1) << SubBits ;
+
+        /*!
+         * \brief Records a value, in O(1).
+         * \param value the value to record.
+         */
+        void record(uint64_t value) ;
+
+        /*!
+         * \brief Returns the number of recorded values.
+         * \return the number of recorded values.
+         */
+        uint64_t count() const ;
+        /*!
+         * \brief Returns the largest recorded value.
+         * \return the largest recorded value.
+         */
+        uint64_t max() const ;
+        /*!
+         * \brief Returns the value below which a given fraction of the
+         * recorded values are, rounded up to the upper bound of its
+         * bucket.
+         * \param p the fraction, in [0,1].
+         * \return the percentile, 0 if no value was recorded.
+         */
+        uint64_t percentile(double p) const ;
+
+        /*!
+         * \brief Adds the values recorded by another histogram.
+         * \param other a histogram of interest.
+         */
+        void merge(const latency_histogram& other) ;
+        /*!
+         * \brief Clears the histogram.
+         */
+        void reset() ;
+
+    private:
+        // methods
+        /*!
+         * \brief Returns the index of the bucket of a value.
+         * \param value the value of interest.
+         * \return the index of the bucket.
+         */
+        static size_t bucket(uint64_t value) ;
+        /*!
+         * \brief Returns the largest value of a bucket.
+         * \param index the index of the bucket.
+         * \return the largest value of the bucket.
+         */
+        static uint64_t upper_bound(size_t index) ;
+
+        // fields
+        /*!
+         * \brief The number of values in each bucket.
+         */
+        std::array<uint64_t, buckets> _counts = {} ;
+        /*!
+         * \brief The number of recorded values.
+         */
+        uint64_t _count = 0 ;
+        /*!
+         * \brief The largest recorded value.
+         */
+        uint64_t _max = 0 ;
+} ;
+
+
+/*!
+ * \brief The latency_instrumentation class is an instrumentation policy (see
+ * heap_instrumentation.hpp) recording the latency of the operations, in ticks
+ * of latency_clock, in one latency_histogram per operation. Recording costs two
+ * reads of the time stamp counter and a bucket increment. To leave it on in
+ * production builds, only one operation out of SamplePeriod may be timed, the
+ * others costing a counter increment.
+ * The histograms take 7 KB each and are allocated with the policy.
+ */
+template<unsigned SamplePeriod = 1>
+class latency_instrumentation
+{
+    static_assert(SamplePeriod > 0, "latency_instrumentation sample period must be positive") ;
+
+    public:
+        typedef latency_histogram<> histogram_type ;
+
+        latency_instrumentation() : _histograms(5), _start(0), _calls(0), _sampled(false) {}
+
+        void begin_operation(heap_operation)
+        {	this->_sampled = (++this->_calls % SamplePeriod) == 0 ;
+            if(this->_sampled)
+            {	this->_start = latency_clock::now() ; }
+        }
+
+        void end_operation(heap_operation operation)
+        {	if(this->_sampled)
+            {	this->_histograms[static_cast<size_t>(operation)].record(latency_clock::now() - this->_start) ; }
+        }
+
+        constexpr void count_comparison() {}
+        constexpr void count_moves(size_t) {}
+        constexpr void count_sift_level(size_t) {}
+
+        /*!
+         * \brief Returns the number of operations, the other
+         * counters being 0.
+         * \return the counters.
+         */
+        heap_counters counters() const
+        {	heap_counters c ;
+            c.operations = this->_calls ;
+            return c ;
+        }
+
+        /*!
+         * \brief Returns the histogram of the latencies of an
+         * operation, in ticks.
+         * \param operation the operation of interest.
+         * \return the histogram.
+         */
+        const histogram_type& histogram(heap_operation operation) const
+        {	return this->_histograms[static_cast<size_t>(operation)] ; }
+
+        /*!
+         * \brief Clears all the histograms.
+         */
+        void reset()
+        {	for(histogram_type& h : this->_histograms)
+            {	h.reset() ; }
+            this->_calls = 0 ;
+        }
+
+    private:
+        /*!
+         * \brief The histograms, indexed by operation.
+         */
+        std::vector<histogram_type> _histograms ;
+        /*!
+         * \brief The time the current operation began at.
+         */
+        uint64_t _start ;
+        /*!
+         * \brief The number of operations.
+         */
+        uint64_t _calls ;
+        /*!
+         * \brief Whether the current operation is timed.
+         */
+        bool _sampled ;
+} ;
+
+
+template<unsigned SubBits>
+void latency_histogram<SubBits>::record(uint64_t value)
+{	this->_counts[bucket(value)]++ ;
+    this->_count++ ;
+    if(value > this->_max)
+    {	this->_max = value ; }
+}
+
+
+template<unsigned SubBits>
+uint64_t latency_histogram<SubBits>::count() const
+{	return this->_count ; }
+
+template<unsigned SubBits>
+uint64_t latency_histogram<SubBits>::max() const
+{	return this->_max ; }
+
+template<unsigned SubBits>
+uint64_t latency_histogram<SubBits>::percentile(double p) const
+{	if(this->_count == 0)
+    {	return 0 ; }
+    // the rank of the value, from 1
+    uint64_t rank = static_cast<uint64_t>(p * this->_count + 0.5) ;
+    if(rank < 1)
+    {	rank = 1 ; }
+    uint64_t seen = 0 ;
+    for(size_t i=0; i<buckets; i++)
+    {	seen += this->_counts[i] ;
+        if(seen >= rank)
+        {	uint64_t bound = upper_bound(i) ;
+            return bound < this->_max ? bound : this->_max ;
+        }
+    }
+    return this->_max ;
+}
+
+
+template<unsigned SubBits>
+void latency_histogram<SubBits>::merge(const latency_histogram& other)
+{	for(size_t i=0; i<buckets; i++)
+    {	this->_counts[i] += other._counts[i] ; }
+    this->_count += other._count ;
+    if(other._max > this->_max)
+    {	this->_max = other._max ; }
+}
+
+template<unsigned SubBits>
+void latency_histogram<SubBits>::reset()
+{	this->_counts.fill(0) ;
+    this->_count = 0 ;
+    this->_max = 0 ;
+}
+
+
+template<unsigned SubBits>
+size_t latency_histogram<SubBits>::bucket(uint64_t value)
+{	if(value < (uint64_t(1) << SubBits))
+    {	return value ; }
+    if(value >> 32)
+    {	return buckets - 1 ; }
+    // the value is m * 2^shift, m having SubBits+1 bits
+    unsigned shift = (63 - __builtin_clzll(value)) - SubBits ;
+    return ((shift + 1) << SubBits) + ((value >> shift) - (uint64_t(1) << SubBits)) ;
+}
+
+template<unsigned SubBits>
+uint64_t latency_histogram<SubBits>::upper_bound(size_t index)
+{	if(index < (size_t(1) << SubBits))
+    {	return index ; }
+    unsigned shift = (index >> SubBits) - 1 ;
+    uint64_t m = (index & ((size_t(1) << SubBits) - 1)) + (uint64_t(1) << SubBits) ;
+    return ((m + 1) << shift) - 1 ;
+}
+
+#endif // LATENCY_INSTRUMENTATION_HPP
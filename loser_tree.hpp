@@ -0,0 +1,271 @@
+#ifndef LOSER_TREE_HPP
+#define LOSER_TREE_HPP
+
+#include <vector>
+#include <iterator>
+#include <functional> // less
+#include <utility>    // move, swap, pair
+#include <stdexcept>
+
+
+/*!
+ * \brief The loser_tree class implements a tournament tree of losers over k
+ * sources, used to merge k sorted sequences. It always exposes the smallest
+ * (with respect to comp) current value of the sources which are not
+ * exhausted. Replacing this value costs one leaf-to-root path, that is
+ * log2(k) comparisons, where a binary heap needs an extraction followed by
+ * an insertion.
+ * The tree is stored in an array : node 0 holds the winner, nodes 1 to k-1
+ * hold the loser of the match played at that node and the children of node i
+ * are nodes 2i and 2i+1, the leaf of source s being node k+s. Each node holds
+ * a copy of its value such that a replay never reads the leaves. On ties, the
+ * source with the lowest index wins, which makes the merge stable.
+ */
+template<class T, class Compare = std::less<T>>
+class loser_tree
+{
+    public:
+        loser_tree() = delete ;
+        /*!
+         * \brief Constructs a tree over k sources, all of
+         * them being exhausted.
+         * \param k the number of sources.
+         * \param comp the comparison function.
+         * \throw std::invalid_argument if k is 0.
+         */
+        loser_tree(size_t k, Compare comp = Compare()) ;
+
+        // methods
+        /*!
+         * \brief Sets the current value of a source. Once all the
+         * sources have been set, build() must be called.
+         * \param source the index of the source.
+         * \param value the current value of the source.
+         */
+        void set(size_t source, T value) ;
+        /*!
+         * \brief Marks a source as exhausted. Once all the
+         * sources have been set, build() must be called.
+         * \param source the index of the source.
+         */
+        void set_exhausted(size_t source) ;
+        /*!
+         * \brief Plays the whole tournament, in O(k).
+         */
+        void build() ;
+
+        /*!
+         * \brief Returns the smallest current value.
+         * \return the smallest current value.
+         */
+        const T& top() const ;
+        /*!
+         * \brief Returns the index of the source holding the
+         * smallest current value.
+         * \return the index of the source.
+         */
+        size_t top_source() const ;
+        /*!
+         * \brief Replaces the smallest current value by the next
+         * value of its source and replays its matches.
+         * \param value the next value of the source.
+         */
+        void replace_top(T value) ;
+        /*!
+         * \brief Marks the source holding the smallest current value
+         * as exhausted and replays its matches.
+         */
+        void exhaust_top() ;
+
+        /*!
+         * \brief Checks whether all the sources are exhausted.
+         * \return whether all the sources are exhausted.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Returns the number of sources.
+         * \return the number of sources.
+         */
+        size_t sources() const ;
+
+    private:
+        /*!
+         * \brief A node of the tree, holding a player.
+         */
+        struct node
+        {	T value ;
+            size_t source ;
+            bool exhausted ;
+        } ;
+
+        // methods
+        /*!
+         * \brief Checks whether a player wins against another.
+         * \param a the first player.
+         * \param b the second player.
+         * \return whether a wins against b.
+         */
+        bool beats(const node& a, const node& b) const ;
+        /*!
+         * \brief Replays the matches from the leaf of the winner
+         * to the root, once its value changed.
+         */
+        void replay() ;
+
+        // fields
+        /*!
+         * \brief The number of sources.
+         */
+        size_t _k ;
+        /*!
+         * \brief The comparison function.
+         */
+        Compare _comp ;
+        /*!
+         * \brief The winner (index 0) and the losers (indices
+         * 1 to k-1) of the matches.
+         */
+        std::vector<node> _tree ;
+        /*!
+         * \brief The players, used until the tree is built.
+         */
+        std::vector<node> _leaves ;
+} ;
+
+
+/*!
+ * \brief Merges k sorted ranges into an output range, using a loser tree.
+ * The ranges only need to be traversed once, such that input iterators,
+ * such as std::istream_iterator, can be used to merge streams.
+ * \param ranges the ranges to merge, as (begin, end) pairs.
+ * \param out the beginning of the output range.
+ * \param comp the comparison function the ranges are sorted with.
+ * \return the end of the output range.
+ */
+template<class InputIt, class OutputIt, class Compare = std::less<>>
+OutputIt loser_tree_merge(std::vector<std::pair<InputIt,InputIt>> ranges, OutputIt out, Compare comp = Compare())
+{	typedef typename std::iterator_traits<InputIt>::value_type value_type ;
+    if(ranges.empty())
+    {	return out ; }
+
+    loser_tree<value_type, Compare> tree(ranges.size(), comp) ;
+    for(size_t i=0; i<ranges.size(); i++)
+    {	if(ranges[i].first != ranges[i].second)
+        {	tree.set(i, *ranges[i].first) ;
+            ++ranges[i].first ;
+        }
+    }
+    tree.build() ;
+
+    while(not tree.empty())
+    {	auto& range = ranges[tree.top_source()] ;
+        *out = tree.top() ;
+        ++out ;
+        if(range.first != range.second)
+        {	tree.replace_top(*range.first) ;
+            ++range.first ;
+        }
+        else
+        {	tree.exhaust_top() ; }
+    }
+    return out ;
+}
+
+
+template<class T, class Compare>
+loser_tree<T,Compare>::loser_tree(size_t k, Compare comp)
+    : _k(k), _comp(comp), _tree(k), _leaves(k)
+{	if(k == 0)
+    {	throw std::invalid_argument("loser_tree needs at least one source!") ; }
+    for(size_t i=0; i<k; i++)
+    {	this->_leaves[i].source = i ;
+        this->_leaves[i].exhausted = true ;
+    }
+    this->build() ;
+}
+
+
+template<class T, class Compare>
+void loser_tree<T,Compare>::set(size_t source, T value)
+{	this->_leaves[source].value = std::move(value) ;
+    this->_leaves[source].exhausted = false ;
+}
+
+template<class T, class Compare>
+void loser_tree<T,Compare>::set_exhausted(size_t source)
+{	this->_leaves[source].exhausted = true ; }
+
+template<class T, class Compare>
+void loser_tree<T,Compare>::build()
+{	// winners[n] is the winner of the match at node n, winners[k+s] the leaf of source s
+    std::vector<size_t> winners(2*this->_k) ;
+    for(size_t s=0; s<this->_k; s++)
+    {	winners[this->_k + s] = s ; }
+    for(size_t n=this->_k-1; n>0; n--)
+    {	size_t a = winners[2*n] ;
+        size_t b = winners[2*n + 1] ;
+        if(this->beats(this->_leaves[a], this->_leaves[b]))
+        {	winners[n] = a ;
+            this->_tree[n] = this->_leaves[b] ;
+        }
+        else
+        {	winners[n] = b ;
+            this->_tree[n] = this->_leaves[a] ;
+        }
+    }
+    this->_tree[0] = this->_leaves[winners[1]] ;
+}
+
+
+template<class T, class Compare>
+const T& loser_tree<T,Compare>::top() const
+{	return this->_tree[0].value ; }
+
+template<class T, class Compare>
+size_t loser_tree<T,Compare>::top_source() const
+{	return this->_tree[0].source ; }
+
+template<class T, class Compare>
+void loser_tree<T,Compare>::replace_top(T value)
+{	this->_tree[0].value = std::move(value) ;
+    this->replay() ;
+}
+
+template<class T, class Compare>
+void loser_tree<T,Compare>::exhaust_top()
+{	this->_tree[0].exhausted = true ;
+    this->replay() ;
+}
+
+
+template<class T, class Compare>
+bool loser_tree<T,Compare>::empty() const
+{	return this->_tree[0].exhausted ; }
+
+template<class T, class Compare>
+size_t loser_tree<T,Compare>::sources() const
+{	return this->_k ; }
+
+
+template<class T, class Compare>
+bool loser_tree<T,Compare>::beats(const node& a, const node& b) const
+{	if(a.exhausted or b.exhausted)
+    {	return b.exhausted and (not a.exhausted or a.source < b.source) ; }
+    if(this->_comp(a.value, b.value))
+    {	return true ; }
+    if(this->_comp(b.value, a.value))
+    {	return false ; }
+    return a.source < b.source ;
+}
+
+template<class T, class Compare>
+void loser_tree<T,Compare>::replay()
+{	node winner = std::move(this->_tree[0]) ;
+    for(size_t n=(this->_k + winner.source)/2; n>0; n/=2)
+    {	if(this->beats(this->_tree[n], winner))
+        {	std::swap(this->_tree[n], winner) ; }
+    }
+    this->_tree[0] = std::move(winner) ;
+}
+
+#endif // LOSER_TREE_HPP
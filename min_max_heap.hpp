@@ -0,0 +1,364 @@
+#ifndef MIN_MAX_HEAP_HPP
+#define MIN_MAX_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <memory>    // allocator
+#include <algorithm> // swap
+#include <utility>   // move
+#include <stdexcept>
+
+
+/*!
+ * \brief The min_max_heap class implements a min-max heap (Atkinson et al.,
+ * 1986), a double-ended priority queue giving access to both its minimum and
+ * its maximum values.
+ * It uses the same array layout as binary_heap : the children of the element
+ * at index i are located at indices 2i+1 and 2i+2. The elements on even levels
+ * (the root being on level 0) are smaller than all their descendants and the
+ * elements on odd levels are greater than all their descendants, such that the
+ * minimum is the root and the maximum is one of its children.
+ */
+template<class T, class Allocator = std::allocator<T>>
+class min_max_heap
+{
+    public:
+        min_max_heap() = delete ;
+        /*!
+         * \brief Constructs an empty min-max heap with a given
+         * maximum size.
+         * \param sizeMax the maximum size of the heap.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        min_max_heap(size_t sizeMax, const Allocator& allocator = Allocator()) ;
+        /*!
+         * \brief Constructs a min-max heap from a given vector.
+         * The maximum size is set to the vector size.
+         * \param v a vector to construct the min-max heap from.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        min_max_heap(const std::vector<T>& v, const Allocator& allocator = Allocator()) ;
+
+        // methods
+        /*!
+         * \brief Returns the maximum value of the heap, in O(1).
+         * \return the maximum value.
+         */
+        T top_max() const ;
+        /*!
+         * \brief Returns the minimum value of the heap, in O(1).
+         * \return the minimum value.
+         */
+        T top_min() const ;
+        /*!
+         * \brief Removes and return the maximum value of the
+         * heap, in O(log(n)).
+         * \return the maximum value.
+         */
+        T extract_max() ;
+        /*!
+         * \brief Removes and return the minimum value of the
+         * heap, in O(log(n)).
+         * \return the minimum value.
+         */
+        T extract_min() ;
+
+        /*!
+         * \brief Insert a given value within the heap, in O(log(n)).
+         * \param value a value to insert.
+         * \throw std::runtime_error if the heap is full.
+         */
+        void insert(T value) ;
+        /*!
+         * \brief Removes the value at the given index, in O(log(n)).
+         * \param index the index of the value to remove.
+         */
+        void remove(int index) ;
+
+        /*!
+         * \brief Searches the heap for the given value and returns
+         * its index. If it could not be found, -1 is returned. This
+         * method is not time efficient (O(n)).
+         * \param value a value to find in the heap.
+         * \return the index of the value if it has been found,
+         * -1 otherwise.
+         */
+        int find(T value) const ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * a min-max heap to a stream.
+         * \param stream an output stream of interest.
+         * \param h a min-max heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U, class A>
+        friend std::ostream& operator << (std::ostream& stream, const min_max_heap<U,A>& h) ;
+
+    private:
+        // methods
+        /*!
+         * \brief Sifts up the element located at a given index,
+         * along the min levels or the max levels.
+         * \param index the index of the element to sift up.
+         */
+        void sift_up(size_t index) ;
+        /*!
+         * \brief Sifts up the element located at a given index
+         * through its grand parents.
+         * \param index the index of the element to sift up.
+         * \param max whether the element goes along the max levels
+         * (otherwise the min levels).
+         */
+        void sift_up_levels(size_t index, bool max) ;
+        /*!
+         * \brief Sifts down (trickles down) the element located at
+         * a given index, through its children and grand children.
+         * \param index the index of the element to sift down.
+         */
+        void sift_down(size_t index) ;
+        /*!
+         * \brief Returns the index of the extreme (the smallest if max
+         * is false, the largest otherwise) value among the children and
+         * grand children of the element at the given index, which
+         * must have at least one child.
+         * \param index the index of the element of interest.
+         * \param max whether the largest value is searched.
+         * \return the index of the extreme descendant.
+         */
+        size_t extreme_descendant(size_t index, bool max) const ;
+        /*!
+         * \brief Returns the index of the maximum value.
+         * \return the index of the maximum value.
+         */
+        size_t max_index() const ;
+
+        /*!
+         * \brief Checks whether the given index is located
+         * on a min level.
+         * \param index the index of interest.
+         * \return whether the index is on a min level.
+         */
+        static bool on_min_level(size_t index) ;
+        /*!
+         * \brief Checks whether a value has to go before another
+         * along the min levels (if max is false) or the max levels.
+         * \param a the first value.
+         * \param b the second value.
+         * \param max whether the values are compared on the max levels.
+         * \return whether a goes before b.
+         */
+        static bool before(const T& a, const T& b, bool max) ;
+
+        // fields
+        /*!
+         * \brief The maximum size of the heap.
+         */
+        size_t _sizeMax ;
+        /*!
+         * \brief The current size of the heap.
+         */
+        size_t _size ;
+        /*!
+         * \brief The vector storing the heap.
+         */
+        std::vector<T, Allocator> _heap ;
+} ;
+
+
+template<class T, class Allocator>
+min_max_heap<T,Allocator>::min_max_heap(size_t sizeMax, const Allocator& allocator)
+    : _sizeMax(sizeMax), _size(0), _heap(sizeMax, allocator)
+{}
+
+template<class T, class Allocator>
+min_max_heap<T,Allocator>::min_max_heap(const std::vector<T>& v, const Allocator& allocator)
+    : _sizeMax(v.size()), _size(v.size()), _heap(v.begin(), v.end(), allocator)
+{	// enforce the min-max heap property for all non-leaf nodes
+    for(size_t i=this->size()/2; i>0; i--)
+    {	this->sift_down(i-1) ; }
+}
+
+
+template<class T, class Allocator>
+T min_max_heap<T,Allocator>::top_max() const
+{	return this->_heap[this->max_index()] ; }
+
+template<class T, class Allocator>
+T min_max_heap<T,Allocator>::top_min() const
+{	return this->_heap[0] ; }
+
+template<class T, class Allocator>
+T min_max_heap<T,Allocator>::extract_max()
+{	size_t index = this->max_index() ;
+    T top = this->_heap[index] ;
+    this->remove(index) ;
+    return top ;
+}
+
+template<class T, class Allocator>
+T min_max_heap<T,Allocator>::extract_min()
+{	T top = this->_heap[0] ;
+    this->remove(0) ;
+    return top ;
+}
+
+
+template<class T, class Allocator>
+void min_max_heap<T,Allocator>::insert(T value)
+{	if(this->full())
+    {	throw std::runtime_error("min_max_heap is full!") ; }
+
+    this->_size++ ;
+    this->_heap[this->size()-1] = std::move(value) ;
+    this->sift_up(this->size()-1) ;
+}
+
+template<class T, class Allocator>
+void min_max_heap<T,Allocator>::remove(int index)
+{	size_t i = index ;
+    this->_size-- ;
+    if(i == this->size())
+    {	return ; }
+    this->_heap[i] = std::move(this->_heap[this->size()]) ;
+    // the last value may have to go up, as it comes from another
+    // subtree. Then, the value at the index (the last value or a
+    // value which came down from the parent) may have to go down
+    this->sift_up(i) ;
+    this->sift_down(i) ;
+}
+
+
+template<class T, class Allocator>
+int min_max_heap<T,Allocator>::find(T value) const
+{   for(size_t i=0; i<this->size(); i++)
+    {   if(this->_heap[i] == value)
+        {   return i ; }
+    }
+    return -1 ;
+}
+
+
+template<class T, class Allocator>
+bool min_max_heap<T,Allocator>::empty() const
+{	return this->size() == 0 ; }
+
+template<class T, class Allocator>
+bool min_max_heap<T,Allocator>::full() const
+{	return this->size() == this->_sizeMax ; }
+
+template<class T, class Allocator>
+size_t min_max_heap<T,Allocator>::size() const
+{	return this->_size ; }
+
+
+template<class T, class Allocator>
+void min_max_heap<T,Allocator>::sift_up(size_t index)
+{	if(index == 0)
+    {	return ; }
+    size_t parent = (index-1) / 2 ;
+    bool max = not on_min_level(index) ;
+    // the value goes to the levels of the other kind if it
+    // is not in order with its parent
+    if(before(this->_heap[index], this->_heap[parent], not max))
+    {	std::swap(this->_heap[index], this->_heap[parent]) ;
+        this->sift_up_levels(parent, not max) ;
+    }
+    else
+    {	this->sift_up_levels(index, max) ; }
+}
+
+template<class T, class Allocator>
+void min_max_heap<T,Allocator>::sift_up_levels(size_t index, bool max)
+{	while(index > 2)
+    {	size_t grand_parent = (((index-1) / 2) - 1) / 2 ;
+        if(not before(this->_heap[index], this->_heap[grand_parent], max))
+        {	break ; }
+        std::swap(this->_heap[index], this->_heap[grand_parent]) ;
+        index = grand_parent ;
+    }
+}
+
+template<class T, class Allocator>
+void min_max_heap<T,Allocator>::sift_down(size_t index)
+{	bool max = not on_min_level(index) ;
+    while((2*index) + 1 < this->size())
+    {	size_t m = this->extreme_descendant(index, max) ;
+        if(not before(this->_heap[m], this->_heap[index], max))
+        {	break ; }
+        std::swap(this->_heap[m], this->_heap[index]) ;
+        if(m <= (2*index) + 2)
+        {	// a child, which has no descendant on the same kind of level
+            break ;
+        }
+        // a grand child, which may now be out of order with its parent
+        size_t parent = (m-1) / 2 ;
+        if(before(this->_heap[m], this->_heap[parent], not max))
+        {	std::swap(this->_heap[m], this->_heap[parent]) ; }
+        index = m ;
+    }
+}
+
+template<class T, class Allocator>
+size_t min_max_heap<T,Allocator>::extreme_descendant(size_t index, bool max) const
+{	size_t m = (2*index) + 1 ;
+    size_t candidates[] = {(2*index) + 2,
+                           (4*index) + 3, (4*index) + 4, (4*index) + 5, (4*index) + 6} ;
+    for(size_t c : candidates)
+    {	if(c >= this->size())
+        {	break ; }
+        if(before(this->_heap[c], this->_heap[m], max))
+        {	m = c ; }
+    }
+    return m ;
+}
+
+template<class T, class Allocator>
+size_t min_max_heap<T,Allocator>::max_index() const
+{	if(this->size() < 3)
+    {	return this->size() - 1 ; }
+    return this->_heap[1] > this->_heap[2] ? 1 : 2 ;
+}
+
+
+template<class T, class Allocator>
+bool min_max_heap<T,Allocator>::on_min_level(size_t index)
+{	// the level is floor(log2(index+1))
+    size_t level = 0 ;
+    for(size_t n=index+1; n>1; n/=2)
+    {	level++ ; }
+    return level % 2 == 0 ;
+}
+
+template<class T, class Allocator>
+bool min_max_heap<T,Allocator>::before(const T& a, const T& b, bool max)
+{	return max ? (a > b) : (a < b) ; }
+
+
+template<class T, class Allocator>
+std::ostream& operator << (std::ostream& stream, const min_max_heap<T,Allocator>& h)
+{	for(size_t i=0; i<h.size(); i++)
+    {	stream << h._heap[i] << ' ' ; }
+    return stream ;
+}
+
+#endif // MIN_MAX_HEAP_HPP
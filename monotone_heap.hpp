@@ -0,0 +1,325 @@
+#ifndef MONOTONE_HEAP_HPP
+#define MONOTONE_HEAP_HPP
+
+#include <iostream>
+#include <type_traits>
+#include <stdexcept>
+#include "binary_heap.hpp"
+#include "radix_heap.hpp"
+
+
+/*!
+ * \brief The switches made by a monotone_heap.
+ */
+struct monotone_stats
+{	/*!
+     * \brief The number of switches from binary_heap to radix_heap.
+     */
+    size_t to_radix = 0 ;
+    /*!
+     * \brief The number of switches from radix_heap back to
+     * binary_heap.
+     */
+    size_t to_heap = 0 ;
+    /*!
+     * \brief The number of extractions made from the radix heap.
+     */
+    size_t radix_extractions = 0 ;
+    /*!
+     * \brief The number of extractions made from the binary heap.
+     */
+    size_t heap_extractions = 0 ;
+} ;
+
+
+/*!
+ * \brief The monotone_heap class implements a maximum priority queue of
+ * integer keys with the interface of binary_heap, which detects monotone
+ * workloads, where no key greater than the last extracted one is inserted
+ * (timers, Dijkstra's algorithm), and then runs them on a radix_heap.
+ * It starts as a binary_heap and watches the extracted keys : after K
+ * consecutive extractions which did not increase, without any insertion above
+ * the last extracted key in between, it moves its elements to a radix_heap.
+ * The first insertion above the last extracted key moves them back to the
+ * binary_heap, as do remove() and change_priority(). find() searches the
+ * radix heap in place, and remove() and change_priority() map its indices back
+ * to the binary heap by value. Each switch costs O(n log(n)), so K doubles each
+ * time the radix heap is left (up to 2^16 K) to bound the cost of workloads
+ * which are only monotone for a while.
+ * The switches are reported by stats().
+ */
+template<class T, size_t K = 64>
+class monotone_heap
+{
+    static_assert(std::is_integral<T>::value, "monotone_heap keys must be integers") ;
+    static_assert(K > 0, "monotone_heap needs at least one extraction to switch") ;
+
+    public:
+        monotone_heap() = delete ;
+        /*!
+         * \brief Constructs an empty heap with a given
+         * maximum size.
+         * \param sizeMax the maximum size of the heap.
+         */
+        monotone_heap(size_t sizeMax) ;
+
+        // methods
+        /*!
+         * \brief Returns the maximum value of the heap.
+         * \return the maximum value.
+         */
+        T top() const ;
+        /*!
+         * \brief Removes and return the maximum value of the
+         * heap.
+         * \return the maximum value.
+         */
+        T extract_top() ;
+
+        /*!
+         * \brief Insert a given value within the heap.
+         * \param value a value to insert.
+         * \throw std::runtime_error if the heap is full.
+         */
+        void insert(T value) ;
+        /*!
+         * \brief Removes the value at the given index.
+         * \param index the index of the value to remove.
+         */
+        void remove(int index) ;
+        /*!
+         * \brief Changes the priority of the value located
+         * at the given index with the given value.
+         * \param index the index of the priority value to change.
+         * \param priority the new priority value.
+         */
+        void change_priority(int index, T priority) ;
+
+        /*!
+         * \brief Searches the heap for the given value and returns
+         * its index. If it could not be found, -1 is returned. This
+         * method is not time efficient (O(n)). It does not leave the
+         * radix heap, the index being then one of the radix heap.
+         * \param value a value to find in the heap.
+         * \return the index of the value if it has been found,
+         * -1 otherwise.
+         */
+        int find(T value) ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+        /*!
+         * \brief Checks whether the elements are in the radix heap.
+         * \return whether the elements are in the radix heap.
+         */
+        bool monotone() const ;
+        /*!
+         * \brief Returns the switches made so far.
+         * \return the statistics of the switches.
+         */
+        const monotone_stats& stats() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * a monotone heap to a stream.
+         * \param stream an output stream of interest.
+         * \param h a monotone heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U, size_t M>
+        friend std::ostream& operator << (std::ostream& stream, const monotone_heap<U,M>& h) ;
+
+    private:
+        // methods
+        /*!
+         * \brief Moves the elements back to the binary heap, if
+         * they are in the radix heap, and maps an index returned by
+         * find() to the binary heap.
+         * \param index an index returned by find().
+         * \return the index in the binary heap.
+         */
+        int leave_radix(int index) ;
+        /*!
+         * \brief Moves the elements to the radix heap.
+         */
+        void to_radix() ;
+        /*!
+         * \brief Moves the elements back to the binary heap.
+         */
+        void to_heap() ;
+
+        // fields
+        /*!
+         * \brief The binary heap.
+         */
+        binary_heap<T> _heap ;
+        /*!
+         * \brief The radix heap.
+         */
+        radix_heap<T> _radix ;
+        /*!
+         * \brief Whether the elements are in the radix heap.
+         */
+        bool _monotone ;
+        /*!
+         * \brief The last extracted key, valid if _run > 0.
+         */
+        T _last ;
+        /*!
+         * \brief The number of consecutive monotone extractions.
+         */
+        size_t _run ;
+        /*!
+         * \brief The number of consecutive monotone extractions
+         * needed to switch to the radix heap.
+         */
+        size_t _required ;
+        /*!
+         * \brief The statistics of the switches.
+         */
+        monotone_stats _stats ;
+} ;
+
+
+template<class T, size_t K>
+monotone_heap<T,K>::monotone_heap(size_t sizeMax)
+    : _heap(sizeMax), _radix(sizeMax), _monotone(false), _last(), _run(0), _required(K)
+{}
+
+
+template<class T, size_t K>
+T monotone_heap<T,K>::top() const
+{	return this->_monotone ? this->_radix.top() : this->_heap.top() ; }
+
+template<class T, size_t K>
+T monotone_heap<T,K>::extract_top()
+{	if(this->_monotone)
+    {	this->_stats.radix_extractions++ ;
+        return this->_radix.extract_top() ;
+    }
+    this->_stats.heap_extractions++ ;
+    T top = this->_heap.extract_top() ;
+    this->_run = ((this->_run > 0) and (top <= this->_last)) ? this->_run + 1 : 1 ; // change <= to >= for min heap
+    this->_last = top ;
+    if((this->_run >= this->_required) and not this->_heap.empty())
+    {	this->to_radix() ; }
+    return top ;
+}
+
+
+template<class T, size_t K>
+void monotone_heap<T,K>::insert(T value)
+{	if(this->_monotone)
+    {	if(value <= this->_radix.bound()) // change <= to >= for min heap
+        {	this->_radix.insert(value) ;
+            return ;
+        }
+        this->to_heap() ;
+    }
+    // an insertion above the last extracted key breaks the monotony
+    if((this->_run > 0) and (value > this->_last)) // change > to < for min heap
+    {	this->_run = 0 ; }
+    this->_heap.insert(value) ;
+}
+
+template<class T, size_t K>
+void monotone_heap<T,K>::remove(int index)
+{	this->_heap.remove(this->leave_radix(index)) ; }
+
+
+template<class T, size_t K>
+void monotone_heap<T,K>::change_priority(int index, T priority)
+{	index = this->leave_radix(index) ;
+    if((this->_run > 0) and (priority > this->_last)) // change > to < for min heap
+    {	this->_run = 0 ; }
+    this->_heap.change_priority(index, priority) ;
+}
+
+
+template<class T, size_t K>
+int monotone_heap<T,K>::find(T value)
+{	return this->_monotone ? this->_radix.find(value) : this->_heap.find(value) ; }
+
+
+template<class T, size_t K>
+bool monotone_heap<T,K>::empty() const
+{	return this->size() == 0 ; }
+
+template<class T, size_t K>
+bool monotone_heap<T,K>::full() const
+{	return this->_monotone ? this->_radix.full() : this->_heap.full() ; }
+
+template<class T, size_t K>
+size_t monotone_heap<T,K>::size() const
+{	return this->_monotone ? this->_radix.size() : this->_heap.size() ; }
+
+template<class T, size_t K>
+bool monotone_heap<T,K>::monotone() const
+{	return this->_monotone ; }
+
+template<class T, size_t K>
+const monotone_stats& monotone_heap<T,K>::stats() const
+{	return this->_stats ; }
+
+
+template<class T, size_t K>
+int monotone_heap<T,K>::leave_radix(int index)
+{	if(not this->_monotone)
+    {	return index ; }
+    // the equal keys are interchangeable, any of them will do
+    T value = this->_radix.at(index) ;
+    this->to_heap() ;
+    return this->_heap.find(value) ;
+}
+
+template<class T, size_t K>
+void monotone_heap<T,K>::to_radix()
+{	// no element is greater than the last extracted key
+    this->_radix.reset(this->_last) ;
+    while(not this->_heap.empty())
+    {	this->_radix.insert(this->_heap.extract_top()) ; }
+    this->_monotone = true ;
+    this->_stats.to_radix++ ;
+}
+
+template<class T, size_t K>
+void monotone_heap<T,K>::to_heap()
+{	// the values come out in decreasing order, such that
+    // the insertions do not sift
+    this->_last = this->_radix.bound() ;
+    while(not this->_radix.empty())
+    {	this->_heap.insert(this->_radix.extract_top()) ; }
+    this->_monotone = false ;
+    this->_run = 0 ;
+    if(this->_required < (K << 16))
+    {	this->_required *= 2 ; }
+    this->_stats.to_heap++ ;
+}
+
+
+template<class T, size_t K>
+std::ostream& operator << (std::ostream& stream, const monotone_heap<T,K>& h)
+{	if(h._monotone)
+    {	stream << h._radix ; }
+    else
+    {	stream << h._heap ; }
+    return stream ;
+}
+
+#endif // MONOTONE_HEAP_HPP
@@ -0,0 +1,351 @@
+#ifndef NORMALIZED_KEY_HPP
+#define NORMALIZED_KEY_HPP
+
+#include <iostream>
+#include <vector>
+#include <memory>  // unique_ptr
+#include <string>
+#include <cstdint>
+#include <cstring> // memcmp, memcpy
+#include <algorithm>
+#include "key_encoding.hpp"
+
+/*
+ * Normalized keys, for ordering rows on several columns (ORDER BY a DESC, b,
+ * ...) : the columns of a row are encoded once into a byte string which
+ * memcmp order is the order of the rows, such that the heaps compare the rows
+ * without a column by column comparator.
+ * The first 8 bytes of the string are held inline, as a big-endian integer,
+ * and the string itself is stored in the arena of the encoder : most rows
+ * are ordered by a single integer comparison of their prefixes, the rest of
+ * the strings being compared only on prefix ties.
+ */
+
+
+/*!
+ * \brief The sort orders of the columns.
+ */
+enum class column_order
+{	ascending,
+    descending
+} ;
+
+
+/*!
+ * \brief The normalized_key class is a memcmp-comparable byte string with its
+ * first 8 bytes held inline as a big-endian integer. The bytes belong to the
+ * normalized_key_encoder which built the key, and are valid as long as it is
+ * not cleared or destroyed.
+ */
+class normalized_key
+{
+    public:
+        /*!
+         * \brief Constructs an empty key.
+         */
+        normalized_key() ;
+        /*!
+         * \brief Constructs a key over a given byte string.
+         * \param bytes the bytes of the key, which must outlive it.
+         * \param size the number of bytes.
+         */
+        normalized_key(const unsigned char* bytes, size_t size) ;
+
+        // methods
+        /*!
+         * \brief Returns the first 8 bytes of the key, as a big-endian
+         * integer padded with zeros.
+         * \return the prefix of the key.
+         */
+        std::uint64_t prefix() const ;
+        /*!
+         * \brief Returns the bytes of the key.
+         * \return the bytes of the key.
+         */
+        const unsigned char* data() const ;
+        /*!
+         * \brief Returns the number of bytes of the key.
+         * \return the size of the key.
+         */
+        size_t size() const ;
+        /*!
+         * \brief Compares two keys in the memcmp order of their bytes,
+         * a shorter key being smaller than the keys it is a prefix of.
+         * \param other a key of interest.
+         * \return a negative value, 0 or a positive value if this key
+         * is smaller than, equal to or greater than the other.
+         */
+        int compare(const normalized_key& other) const ;
+
+    private:
+        // fields
+        /*!
+         * \brief The first 8 bytes, big-endian.
+         */
+        std::uint64_t _prefix ;
+        /*!
+         * \brief The bytes of the key.
+         */
+        const unsigned char* _bytes ;
+        /*!
+         * \brief The number of bytes of the key.
+         */
+        std::uint32_t _size ;
+} ;
+
+inline bool operator < (const normalized_key& a, const normalized_key& b)
+{	return a.compare(b) < 0 ; }
+inline bool operator > (const normalized_key& a, const normalized_key& b)
+{	return a.compare(b) > 0 ; }
+inline bool operator == (const normalized_key& a, const normalized_key& b)
+{	return a.compare(b) == 0 ; }
+inline bool operator != (const normalized_key& a, const normalized_key& b)
+{	return a.compare(b) != 0 ; }
+
+/*!
+ * \brief Overload the << operator to send the bytes of a normalized key
+ * to a stream, in hexadecimal.
+ * \param stream an output stream of interest.
+ * \param key a key of interest.
+ * \return a reference to the stream.
+ */
+inline std::ostream& operator << (std::ostream& stream, const normalized_key& key) ;
+
+
+/*!
+ * \brief The normalized_key_encoder class encodes the columns of rows into
+ * normalized keys, which bytes it stores in an arena :
+ *  - the integers are written big-endian, the sign bit of the signed ones
+ *    being flipped,
+ *  - the float and double values are written as their order-preserving codes
+ *    (see key_encoding.hpp),
+ *  - the strings have their 0 bytes escaped as 0x00 0xff and are terminated
+ *    by 0x00 0x00, such that a string comes before its extensions,
+ *  - the bytes of the descending columns are inverted.
+ * Each encoding is prefix-free, such that the order of the keys is the
+ * lexicographic order of the columns. The columns of a key are added in the
+ * order of the ORDER BY clause and the key is taken by finish().
+ */
+class normalized_key_encoder
+{
+    public:
+        /*!
+         * \brief Constructs an encoder with an empty arena.
+         * \param chunk_size the size of the blocks of the arena.
+         */
+        normalized_key_encoder(size_t chunk_size = 65536) ;
+
+        // methods
+        /*!
+         * \brief Adds an integer column to the current key.
+         * \param value the value of the column.
+         * \param order the order of the column.
+         * \return a reference to the encoder.
+         */
+        normalized_key_encoder& add(std::int32_t value, column_order order = column_order::ascending) ;
+        normalized_key_encoder& add(std::int64_t value, column_order order = column_order::ascending) ;
+        normalized_key_encoder& add(std::uint32_t value, column_order order = column_order::ascending) ;
+        normalized_key_encoder& add(std::uint64_t value, column_order order = column_order::ascending) ;
+        /*!
+         * \brief Adds a floating point column to the current key, the
+         * NaNs coming after +infinity.
+         * \param value the value of the column.
+         * \param order the order of the column.
+         * \return a reference to the encoder.
+         */
+        normalized_key_encoder& add(float value, column_order order = column_order::ascending) ;
+        normalized_key_encoder& add(double value, column_order order = column_order::ascending) ;
+        /*!
+         * \brief Adds a string column to the current key.
+         * \param value the characters of the column.
+         * \param size the number of characters.
+         * \param order the order of the column.
+         * \return a reference to the encoder.
+         */
+        normalized_key_encoder& add(const char* value, size_t size, column_order order = column_order::ascending) ;
+        normalized_key_encoder& add(const std::string& value, column_order order = column_order::ascending) ;
+
+        /*!
+         * \brief Stores the current key in the arena and starts
+         * a new one.
+         * \return the key.
+         */
+        normalized_key finish() ;
+        /*!
+         * \brief Releases the arena, the keys becoming invalid.
+         */
+        void clear() ;
+        /*!
+         * \brief Returns the number of bytes allocated by the arena.
+         * \return the size of the arena.
+         */
+        size_t capacity() const ;
+
+    private:
+        // methods
+        /*!
+         * \brief Appends an unsigned integer to the current key,
+         * big-endian.
+         * \param code the integer.
+         * \param bytes the number of bytes of the integer.
+         * \param order the order of the column.
+         */
+        void append(std::uint64_t code, size_t bytes, column_order order) ;
+
+        // fields
+        /*!
+         * \brief The size of the blocks of the arena.
+         */
+        size_t _chunk_size ;
+        /*!
+         * \brief The blocks of the arena.
+         */
+        std::vector<std::unique_ptr<unsigned char[]>> _chunks ;
+        /*!
+         * \brief The number of bytes used in the last block.
+         */
+        size_t _used ;
+        /*!
+         * \brief The number of bytes allocated.
+         */
+        size_t _capacity ;
+        /*!
+         * \brief The bytes of the current key.
+         */
+        std::vector<unsigned char> _current ;
+} ;
+
+
+inline normalized_key::normalized_key()
+    : _prefix(0), _bytes(nullptr), _size(0)
+{}
+
+inline normalized_key::normalized_key(const unsigned char* bytes, size_t size)
+    : _prefix(0), _bytes(bytes), _size(static_cast<std::uint32_t>(size))
+{	for(size_t i=0; i<8; i++)
+    {	this->_prefix = (this->_prefix << 8) | (i < size ? bytes[i] : 0) ; }
+}
+
+
+inline std::uint64_t normalized_key::prefix() const
+{	return this->_prefix ; }
+
+inline const unsigned char* normalized_key::data() const
+{	return this->_bytes ; }
+
+inline size_t normalized_key::size() const
+{	return this->_size ; }
+
+inline int normalized_key::compare(const normalized_key& other) const
+{	if(this->_prefix != other._prefix)
+    {	return this->_prefix < other._prefix ? -1 : 1 ; }
+    // the prefixes tie, the bytes after them decide, then
+    // the sizes (the zero padding of the shorter prefix
+    // made it equal to the bytes of the longer one)
+    size_t size = std::min(this->_size, other._size) ;
+    if(size > 8)
+    {	int c = std::memcmp(this->_bytes + 8, other._bytes + 8, size - 8) ;
+        if(c != 0)
+        {	return c ; }
+    }
+    if(this->_size != other._size)
+    {	return this->_size < other._size ? -1 : 1 ; }
+    return 0 ;
+}
+
+inline std::ostream& operator << (std::ostream& stream, const normalized_key& key)
+{	const char* digits = "0123456789abcdef" ;
+    for(size_t i=0; i<key.size(); i++)
+    {	stream << digits[key.data()[i] >> 4] << digits[key.data()[i] & 0xf] ; }
+    return stream << ' ' ;
+}
+
+
+inline normalized_key_encoder::normalized_key_encoder(size_t chunk_size)
+    : _chunk_size(chunk_size), _used(0), _capacity(0)
+{}
+
+
+inline normalized_key_encoder& normalized_key_encoder::add(std::int32_t value, column_order order)
+{	this->append(key_encoding<std::int32_t>::encode(value), 4, order) ;
+    return *this ;
+}
+
+inline normalized_key_encoder& normalized_key_encoder::add(std::int64_t value, column_order order)
+{	this->append(static_cast<std::uint64_t>(value) ^ (std::uint64_t(1) << 63), 8, order) ;
+    return *this ;
+}
+
+inline normalized_key_encoder& normalized_key_encoder::add(std::uint32_t value, column_order order)
+{	this->append(value, 4, order) ;
+    return *this ;
+}
+
+inline normalized_key_encoder& normalized_key_encoder::add(std::uint64_t value, column_order order)
+{	this->append(value, 8, order) ;
+    return *this ;
+}
+
+inline normalized_key_encoder& normalized_key_encoder::add(float value, column_order order)
+{	this->append(key_encoding<float>::encode(value), 4, order) ;
+    return *this ;
+}
+
+inline normalized_key_encoder& normalized_key_encoder::add(double value, column_order order)
+{	this->append(key_encoding<double>::encode(value), 8, order) ;
+    return *this ;
+}
+
+inline normalized_key_encoder& normalized_key_encoder::add(const char* value, size_t size, column_order order)
+{	unsigned char mask = order == column_order::descending ? 0xff : 0x00 ;
+    for(size_t i=0; i<size; i++)
+    {	unsigned char c = static_cast<unsigned char>(value[i]) ;
+        this->_current.push_back(c ^ mask) ;
+        if(c == 0)
+        {	this->_current.push_back(0xff ^ mask) ; }
+    }
+    this->_current.push_back(mask) ;
+    this->_current.push_back(mask) ;
+    return *this ;
+}
+
+inline normalized_key_encoder& normalized_key_encoder::add(const std::string& value, column_order order)
+{	return this->add(value.data(), value.size(), order) ; }
+
+
+inline normalized_key normalized_key_encoder::finish()
+{	size_t size = this->_current.size() ;
+    if(this->_chunks.empty() or (this->_used + size > this->_chunk_size))
+    {	// the keys larger than a block get their own block
+        size_t chunk_size = std::max(this->_chunk_size, size) ;
+        this->_chunks.emplace_back(new unsigned char[chunk_size]) ;
+        this->_capacity += chunk_size ;
+        this->_used = 0 ;
+    }
+    unsigned char* bytes = this->_chunks.back().get() + this->_used ;
+    if(size > 0)
+    {	std::memcpy(bytes, this->_current.data(), size) ; }
+    this->_used += size ;
+    this->_current.clear() ;
+    return normalized_key(bytes, size) ;
+}
+
+inline void normalized_key_encoder::clear()
+{	this->_chunks.clear() ;
+    this->_capacity = 0 ;
+    this->_used = 0 ;
+    this->_current.clear() ;
+}
+
+inline size_t normalized_key_encoder::capacity() const
+{	return this->_capacity ; }
+
+
+inline void normalized_key_encoder::append(std::uint64_t code, size_t bytes, column_order order)
+{	if(order == column_order::descending)
+    {	code = ~code ; }
+    for(size_t i=bytes; i>0; i--)
+    {	this->_current.push_back(static_cast<unsigned char>(code >> (8*(i-1)))) ; }
+}
+
+#endif // NORMALIZED_KEY_HPP
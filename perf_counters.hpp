@@ -0,0 +1,299 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <cstring> // memset
+#include <vector>
+#include "heap_instrumentation.hpp"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+
+/*!
+ * \brief The hardware events counted by perf_counters.
+ */
+enum class perf_event
+{	l1d_misses,
+    llc_misses,
+    dtlb_misses,
+    branch_misses
+} ;
+
+/*!
+ * \brief The values of the hardware events.
+ */
+struct perf_values
+{	/*!
+     * \brief The L1 data cache read misses.
+     */
+    uint64_t l1d_misses = 0 ;
+    /*!
+     * \brief The last level cache misses.
+     */
+    uint64_t llc_misses = 0 ;
+    /*!
+     * \brief The data TLB read misses.
+     */
+    uint64_t dtlb_misses = 0 ;
+    /*!
+     * \brief The mispredicted branches.
+     */
+    uint64_t branch_misses = 0 ;
+} ;
+
+
+/*!
+ * \brief The perf_counters class counts hardware events of the calling thread,
+ * in user space, through a perf_event_open group (Linux only). The events which
+ * cannot be opened (no PMU in a virtual machine, perf_event_paranoid above 2,
+ * another operating system) are reported as unavailable and read as 0, such
+ * that the callers only have to check available().
+ */
+class perf_counters
+{
+    public:
+        /*!
+         * \brief Opens the counters, which are stopped.
+         */
+        perf_counters() ;
+        perf_counters(const perf_counters&) = delete ;
+        perf_counters& operator = (const perf_counters&) = delete ;
+        ~perf_counters() ;
+
+        /*!
+         * \brief Checks whether at least one event could be opened.
+         * \return whether the counters are available.
+         */
+        bool available() const ;
+        /*!
+         * \brief Checks whether an event could be opened.
+         * \param event the event of interest.
+         * \return whether the event is available.
+         */
+        bool available(perf_event event) const ;
+
+        /*!
+         * \brief Starts (or resumes) counting.
+         */
+        void start() ;
+        /*!
+         * \brief Stops counting.
+         */
+        void stop() ;
+        /*!
+         * \brief Resets the counts to 0.
+         */
+        void reset() ;
+        /*!
+         * \brief Returns the counts, since the last reset.
+         * \return the counts.
+         */
+        perf_values read() const ;
+
+    private:
+        // methods
+        /*!
+         * \brief Returns the count of an event.
+         * \param event the event of interest.
+         * \return the count, 0 if the event is unavailable.
+         */
+        uint64_t read(perf_event event) const ;
+        /*!
+         * \brief Applies an ioctl to the whole group.
+         * \param request the request.
+         */
+        void control(unsigned long request) ;
+
+        // fields
+        /*!
+         * \brief The file descriptors of the events, -1 for the
+         * unavailable ones, indexed by event.
+         */
+        int _fds[4] ;
+        /*!
+         * \brief The file descriptor of the group leader, the first
+         * available event.
+         */
+        int _leader ;
+} ;
+
+
+/*!
+ * \brief The perf_instrumentation class is an instrumentation policy (see
+ * heap_instrumentation.hpp) counting the hardware events of each operation
+ * with one perf_counters group per operation, enabled during the operations
+ * of its kind only. Each operation costs two system calls, such that this
+ * policy is meant for tuning, not for production.
+ */
+class perf_instrumentation
+{
+    public:
+        perf_instrumentation() : _counters(5), _operations{} {}
+
+        void begin_operation(heap_operation operation)
+        {	this->_operations[static_cast<size_t>(operation)]++ ;
+            this->_counters[static_cast<size_t>(operation)].start() ;
+        }
+
+        void end_operation(heap_operation operation)
+        {	this->_counters[static_cast<size_t>(operation)].stop() ; }
+
+        constexpr void count_comparison() {}
+        constexpr void count_moves(size_t) {}
+        constexpr void count_sift_level(size_t) {}
+
+        /*!
+         * \brief Returns the number of operations, the other
+         * counters being 0.
+         * \return the counters.
+         */
+        heap_counters counters() const
+        {	heap_counters c ;
+            for(size_t n : this->_operations)
+            {	c.operations += n ; }
+            return c ;
+        }
+
+        /*!
+         * \brief Returns the number of operations of a kind.
+         * \param operation the operation of interest.
+         * \return the number of operations.
+         */
+        size_t operations(heap_operation operation) const
+        {	return this->_operations[static_cast<size_t>(operation)] ; }
+
+        /*!
+         * \brief Checks whether the hardware counters are available.
+         * \return whether the counters are available.
+         */
+        bool available() const
+        {	return this->_counters[0].available() ; }
+
+        /*!
+         * \brief Returns the hardware events counted during the
+         * operations of a kind.
+         * \param operation the operation of interest.
+         * \return the counts.
+         */
+        perf_values events(heap_operation operation) const
+        {	return this->_counters[static_cast<size_t>(operation)].read() ; }
+
+    private:
+        /*!
+         * \brief The counters, indexed by operation. perf_counters
+         * is not copyable, hence a vector built once.
+         */
+        std::vector<perf_counters> _counters ;
+        /*!
+         * \brief The number of operations, indexed by operation.
+         */
+        size_t _operations[5] ;
+} ;
+
+
+#ifdef __linux__
+
+inline perf_counters::perf_counters()
+    : _leader(-1)
+{	const uint64_t l1d = PERF_COUNT_HW_CACHE_L1D
+                         | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                         | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) ;
+    const uint64_t dtlb = PERF_COUNT_HW_CACHE_DTLB
+                          | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                          | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) ;
+    const uint32_t types[] = {PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE,
+                              PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE} ;
+    const uint64_t configs[] = {l1d, PERF_COUNT_HW_CACHE_MISSES,
+                                dtlb, PERF_COUNT_HW_BRANCH_MISSES} ;
+    for(int i=0; i<4; i++)
+    {	perf_event_attr attr ;
+        std::memset(&attr, 0, sizeof(attr)) ;
+        attr.size = sizeof(attr) ;
+        attr.type = types[i] ;
+        attr.config = configs[i] ;
+        attr.disabled = this->_leader == -1 ? 1 : 0 ;
+        attr.exclude_kernel = 1 ;
+        attr.exclude_hv = 1 ;
+        this->_fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, this->_leader, 0)) ;
+        if(this->_fds[i] < 0)
+        {	this->_fds[i] = -1 ; }
+        else if(this->_leader == -1)
+        {	this->_leader = this->_fds[i] ; }
+    }
+}
+
+inline perf_counters::~perf_counters()
+{	for(int fd : this->_fds)
+    {	if(fd != -1)
+        {	close(fd) ; }
+    }
+}
+
+
+inline void perf_counters::control(unsigned long request)
+{	if(this->_leader != -1)
+    {	ioctl(this->_leader, request, PERF_IOC_FLAG_GROUP) ; }
+}
+
+inline void perf_counters::start()
+{	this->control(PERF_EVENT_IOC_ENABLE) ; }
+
+inline void perf_counters::stop()
+{	this->control(PERF_EVENT_IOC_DISABLE) ; }
+
+inline void perf_counters::reset()
+{	this->control(PERF_EVENT_IOC_RESET) ; }
+
+
+inline uint64_t perf_counters::read(perf_event event) const
+{	int fd = this->_fds[static_cast<int>(event)] ;
+    uint64_t value = 0 ;
+    if((fd == -1) or (::read(fd, &value, sizeof(value)) != sizeof(value)))
+    {	return 0 ; }
+    return value ;
+}
+
+#else
+
+inline perf_counters::perf_counters()
+    : _fds{-1, -1, -1, -1}, _leader(-1)
+{}
+
+inline perf_counters::~perf_counters()
+{}
+
+inline void perf_counters::start()
+{}
+
+inline void perf_counters::stop()
+{}
+
+inline void perf_counters::reset()
+{}
+
+inline uint64_t perf_counters::read(perf_event) const
+{	return 0 ; }
+
+#endif
+
+
+inline bool perf_counters::available() const
+{	return this->_leader != -1 ; }
+
+inline bool perf_counters::available(perf_event event) const
+{	return this->_fds[static_cast<int>(event)] != -1 ; }
+
+inline perf_values perf_counters::read() const
+{	perf_values values ;
+    values.l1d_misses = this->read(perf_event::l1d_misses) ;
+    values.llc_misses = this->read(perf_event::llc_misses) ;
+    values.dtlb_misses = this->read(perf_event::dtlb_misses) ;
+    values.branch_misses = this->read(perf_event::branch_misses) ;
+    return values ;
+}
+
+#endif // PERF_COUNTERS_HPP
@@ -0,0 +1,365 @@
+#ifndef RADIX_HEAP_HPP
+#define RADIX_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <stdexcept>
+#include <limits>
+#include "key_encoding.hpp"
+
+
+/*!
+ * \brief The radix_heap class implements a maximum radix heap (Ahuja et al.,
+ * 1990) of integer or floating point keys, a monotone priority queue : a key may only be
+ * inserted if it is not greater than the last extracted key. Under this
+ * condition, which holds for timers and Dijkstra's algorithm, an insertion
+ * costs O(1) and an extraction O(log(C)) amortized, C being the range of the
+ * keys, without comparing the keys of a heap.
+ * The keys are stored in 65 buckets, relatively to the last extracted key :
+ * bucket 0 holds the keys equal to it and bucket i the keys which first
+ * differ from it on bit i-1 (from the least significant one). An extraction
+ * takes a key from bucket 0, refilling it when empty by redistributing the
+ * first non empty bucket relatively to its largest key, each key only going
+ * down. The largest key of each bucket is kept along with a mask of the non
+ * empty buckets, such that top() is O(1) and leaves the buckets untouched.
+ * The float and double keys are mapped to integers by their order-preserving
+ * encoding (see key_encoding.hpp), which also orders the NaNs.
+ */
+template<class T>
+class radix_heap
+{
+    static_assert((std::is_integral<T>::value and (sizeof(T) <= 8)) or std::is_same<T,float>::value
+                  or std::is_same<T,double>::value, "radix_heap keys must be integers, float or double") ;
+
+    public:
+        /*!
+         * \brief Constructs an empty radix heap with a given
+         * maximum size.
+         * \param sizeMax the maximum size of the heap, unbounded
+         * by default.
+         */
+        radix_heap(size_t sizeMax = std::numeric_limits<size_t>::max()) ;
+
+        // methods
+        /*!
+         * \brief Returns the maximum value of the heap.
+         * \return the maximum value.
+         */
+        T top() const ;
+        /*!
+         * \brief Removes and return the maximum value of the
+         * heap.
+         * \return the maximum value.
+         */
+        T extract_top() ;
+        /*!
+         * \brief Insert a given value within the heap, in O(1).
+         * \param value a value to insert, not greater than bound().
+         * \throw std::runtime_error if the heap is full or if the
+         * value is greater than bound().
+         */
+        void insert(T value) ;
+
+        /*!
+         * \brief Returns the largest value which can be inserted,
+         * the last extracted value (the maximum of T at first, or
+         * the largest NaN for floating point keys).
+         * \return the largest value which can be inserted.
+         */
+        T bound() const ;
+        /*!
+         * \brief Sets the largest value which can be inserted,
+         * the heap having to be empty.
+         * \param bound the largest value which can be inserted.
+         */
+        void reset(T bound) ;
+
+        /*!
+         * \brief Searches the heap for the given value and returns
+         * its index, the values being indexed bucket after bucket.
+         * If it could not be found, -1 is returned. This method is
+         * not time efficient (O(n)).
+         * \param value a value to find in the heap.
+         * \return the index of the value if it has been found,
+         * -1 otherwise.
+         */
+        int find(T value) const ;
+        /*!
+         * \brief Returns the value at the given index, as returned
+         * by find(), in O(1) per bucket.
+         * \param index the index of the value.
+         * \return the value.
+         * \throw std::runtime_error if the index is out of range.
+         */
+        T at(int index) const ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * a radix heap to a stream.
+         * \param stream an output stream of interest.
+         * \param h a radix heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U>
+        friend std::ostream& operator << (std::ostream& stream, const radix_heap<U>& h) ;
+
+    private:
+        // methods
+        /*!
+         * \brief Maps a key to an unsigned code, the codes being in
+         * the reverse order of the keys, such that the maximum key
+         * has the minimum code.
+         * \param key the key of interest.
+         * \return the code of the key.
+         */
+        static uint64_t encode(T key) ;
+        /*!
+         * \brief Maps a code back to its key.
+         * \param code the code of interest.
+         * \return the key.
+         */
+        static T decode(uint64_t code) ;
+        /*!
+         * \brief Returns the bucket of a code, relatively to the
+         * last extracted code.
+         * \param code the code of interest.
+         * \return the index of the bucket.
+         */
+        size_t bucket(uint64_t code) const ;
+        /*!
+         * \brief Adds a code to its bucket.
+         * \param code the code of interest.
+         */
+        void push(uint64_t code) ;
+        /*!
+         * \brief Returns the index of the first non empty bucket
+         * above bucket 0, the heap having to be not empty.
+         * \return the index of the bucket.
+         */
+        size_t first_bucket() const ;
+
+        // fields
+        /*!
+         * \brief The maximum size of the heap.
+         */
+        size_t _sizeMax ;
+        /*!
+         * \brief The current size of the heap.
+         */
+        size_t _size ;
+        /*!
+         * \brief The code of the last extracted key.
+         */
+        uint64_t _last ;
+        /*!
+         * \brief The codes of the keys, by bucket.
+         */
+        std::array<std::vector<uint64_t>, 65> _buckets ;
+        /*!
+         * \brief The smallest code of each bucket, that is
+         * its largest key.
+         */
+        std::array<uint64_t, 65> _minimums ;
+        /*!
+         * \brief The mask of the non empty buckets, bit i-1
+         * standing for bucket i.
+         */
+        uint64_t _occupied ;
+} ;
+
+
+template<class T>
+radix_heap<T>::radix_heap(size_t sizeMax)
+    : _sizeMax(sizeMax), _size(0), _minimums{}, _occupied(0)
+{	// the smallest code for floating point keys, such that
+    // the infinities and the NaNs can be inserted
+    this->_last = std::is_floating_point<T>::value ? 0 : encode(std::numeric_limits<T>::max()) ;
+}
+
+
+template<class T>
+T radix_heap<T>::top() const
+{	if(not this->_buckets[0].empty())
+    {	return decode(this->_last) ; }
+    return decode(this->_minimums[this->first_bucket()]) ;
+}
+
+template<class T>
+T radix_heap<T>::extract_top()
+{	if(this->_buckets[0].empty())
+    {	// the largest key of the first non empty bucket becomes
+        // the last extracted one, its keys going down
+        size_t i = this->first_bucket() ;
+        this->_last = this->_minimums[i] ;
+        std::vector<uint64_t> codes = std::move(this->_buckets[i]) ;
+        this->_buckets[i].clear() ;
+        this->_occupied &= ~(uint64_t(1) << (i-1)) ;
+        for(uint64_t code : codes)
+        {	this->push(code) ; }
+        // give the storage back to the bucket
+        codes.clear() ;
+        this->_buckets[i] = std::move(codes) ;
+    }
+    this->_buckets[0].pop_back() ;
+    this->_size-- ;
+    return decode(this->_last) ;
+}
+
+template<class T>
+void radix_heap<T>::insert(T value)
+{	if(this->full())
+    {	throw std::runtime_error("radix_heap is full!") ; }
+    uint64_t code = encode(value) ;
+    if(code < this->_last)
+    {	throw std::runtime_error("radix_heap key is greater than the last extracted key!") ; }
+    this->push(code) ;
+    this->_size++ ;
+}
+
+
+template<class T>
+T radix_heap<T>::bound() const
+{	return decode(this->_last) ; }
+
+template<class T>
+void radix_heap<T>::reset(T bound)
+{	this->_last = encode(bound) ; }
+
+
+template<class T>
+int radix_heap<T>::find(T value) const
+{	uint64_t code = encode(value) ;
+    int index = 0 ;
+    for(const auto& bucket : this->_buckets)
+    {	for(uint64_t c : bucket)
+        {	if(c == code)
+            {	return index ; }
+            index++ ;
+        }
+    }
+    return -1 ;
+}
+
+template<class T>
+T radix_heap<T>::at(int index) const
+{	size_t i = index ;
+    for(const auto& bucket : this->_buckets)
+    {	if(i < bucket.size())
+        {	return decode(bucket[i]) ; }
+        i -= bucket.size() ;
+    }
+    throw std::runtime_error("radix_heap index out of range!") ;
+}
+
+
+template<class T>
+bool radix_heap<T>::empty() const
+{	return this->size() == 0 ; }
+
+template<class T>
+bool radix_heap<T>::full() const
+{	return this->size() == this->_sizeMax ; }
+
+template<class T>
+size_t radix_heap<T>::size() const
+{	return this->_size ; }
+
+
+template<class T>
+uint64_t radix_heap<T>::encode(T key)
+{	uint64_t code = 0 ;
+    if constexpr(std::is_floating_point<T>::value)
+    {	code = key_encoding<T>::encode(key) ; }
+    else if constexpr(std::is_signed<T>::value)
+    {	// flip the sign bit such that the negative keys come first
+        code = static_cast<uint64_t>(static_cast<int64_t>(key)) ^ (uint64_t(1) << 63) ;
+    }
+    else
+    {	code = static_cast<uint64_t>(key) ; }
+    return ~code ; // remove ~ for min heap
+}
+
+template<class T>
+T radix_heap<T>::decode(uint64_t code)
+{	code = ~code ; // remove ~ for min heap
+    if constexpr(std::is_floating_point<T>::value)
+    {	return key_encoding<T>::decode(static_cast<typename key_encoding<T>::code_type>(code)) ; }
+    else if constexpr(std::is_signed<T>::value)
+    {	return static_cast<T>(static_cast<int64_t>(code ^ (uint64_t(1) << 63))) ; }
+    else
+    {	return static_cast<T>(code) ; }
+}
+
+template<class T>
+size_t radix_heap<T>::bucket(uint64_t code) const
+{	uint64_t diff = code ^ this->_last ;
+#if defined(__GNUC__)
+    return diff == 0 ? 0 : 64 - __builtin_clzll(diff) ;
+#else
+    // the position of the most significant bit set, from 1
+    size_t i = 0 ;
+    for(; diff != 0; diff >>= 1)
+    {	i++ ; }
+    return i ;
+#endif
+}
+
+template<class T>
+void radix_heap<T>::push(uint64_t code)
+{	size_t i = this->bucket(code) ;
+    if(i > 0)
+    {	uint64_t bit = uint64_t(1) << (i-1) ;
+        if(((this->_occupied & bit) == 0) or (code < this->_minimums[i]))
+        {	this->_minimums[i] = code ; }
+        this->_occupied |= bit ;
+    }
+    this->_buckets[i].push_back(code) ;
+}
+
+template<class T>
+size_t radix_heap<T>::first_bucket() const
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(this->_occupied) + 1 ;
+#else
+    // the position of the least significant bit set, from 1
+    size_t i = 1 ;
+    for(uint64_t occupied = this->_occupied; (occupied & 1) == 0; occupied >>= 1)
+    {	i++ ; }
+    return i ;
+#endif
+}
+
+
+template<class T>
+std::ostream& operator << (std::ostream& stream, const radix_heap<T>& h)
+{	for(const auto& bucket : h._buckets)
+    {	for(uint64_t code : bucket)
+        {	stream << +radix_heap<T>::decode(code) << ' ' ; }
+    }
+    return stream ;
+}
+
+#endif // RADIX_HEAP_HPP
@@ -0,0 +1,434 @@
+#ifndef RECORD_HEAP_HPP
+#define RECORD_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cstring> // memcpy, memcmp
+#include <type_traits>
+#include <stdexcept>
+#include "key_encoding.hpp"
+
+
+/*!
+ * \brief The types of the keys of the records of a record_heap.
+ */
+enum class record_key
+{	int32,
+    uint32,
+    int64,
+    uint64,
+    float32,
+    float64
+} ;
+
+
+/*!
+ * \brief The record_heap class implements a maximum binary heap of fixed
+ * width records which layout is only known at run time : the size of the
+ * records, the offset of their key and the type of the key are given at
+ * construction, and the records are stored back to back in a byte buffer.
+ * The records are copied in and out through pointers, without boxing.
+ * Each operation dispatches once on the key type and the record size to a
+ * sift kernel compiled for them, in which the records are moved by a memcpy
+ * of a constant size (8, 16, 32 or 64 bytes, other sizes using a memcpy of
+ * the run time size) and the keys are loaded at a constant type. The float
+ * and double keys are compared through their order-preserving codes (see
+ * key_encoding.hpp), which orders the NaNs.
+ */
+class record_heap
+{
+    public:
+        record_heap() = delete ;
+        /*!
+         * \brief Constructs an empty heap with a given maximum size
+         * and record layout.
+         * \param sizeMax the maximum number of records of the heap.
+         * \param record_size the size of the records, in bytes.
+         * \param key_offset the offset of the key in the records,
+         * in bytes.
+         * \param key_type the type of the key.
+         * \throw std::runtime_error if the key does not fit in the
+         * records.
+         */
+        record_heap(size_t sizeMax, size_t record_size, size_t key_offset, record_key key_type) ;
+
+        // methods
+        /*!
+         * \brief Returns the record of maximum key, which is valid
+         * until the next modification of the heap.
+         * \return a pointer to the maximum record.
+         */
+        const void* top() const ;
+        /*!
+         * \brief Removes the record of maximum key and copies it.
+         * \param record the memory receiving the record, of
+         * record_size() bytes.
+         */
+        void extract_top(void* record) ;
+
+        /*!
+         * \brief Insert a copy of a given record within the heap.
+         * \param record the record to insert, of record_size()
+         * bytes.
+         * \throw std::runtime_error if the heap is full.
+         */
+        void insert(const void* record) ;
+        /*!
+         * \brief Removes the record at the given index.
+         * \param index the index of the record to remove.
+         */
+        void remove(int index) ;
+        /*!
+         * \brief Replaces the record located at the given index
+         * with the given record.
+         * \param index the index of the record to replace.
+         * \param record the new record, of record_size() bytes.
+         */
+        void change_priority(int index, const void* record) ;
+
+        /*!
+         * \brief Searches the heap for a record equal to the given
+         * one, byte per byte, and returns its index. If it could
+         * not be found, -1 is returned. This method is not time
+         * efficient (O(n)).
+         * \param record a record to find in the heap.
+         * \return the index of the record if it has been found,
+         * -1 otherwise.
+         */
+        int find(const void* record) const ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current number of records of the heap.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+        /*!
+         * \brief Returns the size of the records.
+         * \return the size of the records, in bytes.
+         */
+        size_t record_size() const ;
+        /*!
+         * \brief Returns the offset of the key in the records.
+         * \return the offset of the key, in bytes.
+         */
+        size_t key_offset() const ;
+        /*!
+         * \brief Returns the type of the keys.
+         * \return the type of the keys.
+         */
+        record_key key_type() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send the keys of a record
+         * heap to a stream.
+         * \param stream an output stream of interest.
+         * \param h a record heap of interest.
+         * \return a reference to the stream.
+         */
+        friend std::ostream& operator << (std::ostream& stream, const record_heap& h) ;
+
+    private:
+        /*!
+         * \brief Stands for a key type in the dispatch.
+         */
+        template<class Key>
+        struct key_tag
+        {	typedef Key type ; } ;
+
+        // methods
+        /*!
+         * \brief Calls a function with the key type and the record
+         * size as types, the size being 0 when it has no kernel.
+         * \param f a function taking a key_tag and a
+         * std::integral_constant<size_t, Width>.
+         */
+        template<class F>
+        void dispatch(F f) const ;
+        template<class Key, class F>
+        void dispatch_width(F f) const ;
+
+        /*!
+         * \brief Loads the key of a record, as an integer in the
+         * order of the keys.
+         * \param record the record of interest.
+         * \return the key, or its code for the floating points.
+         */
+        template<class Key>
+        auto load_key(const unsigned char* record) const ;
+        /*!
+         * \brief Copies a record.
+         * \param destination the memory receiving the record.
+         * \param source the record to copy.
+         */
+        template<size_t Width>
+        void move(unsigned char* destination, const unsigned char* source) const ;
+        /*!
+         * \brief Returns the address of the record at a given index.
+         * \param index the index of the record of interest.
+         * \return the address of the record.
+         */
+        unsigned char* record(size_t index) ;
+        const unsigned char* record(size_t index) const ;
+
+        /*!
+         * \brief Sifts up the value record from a hole.
+         * \param hole the index of the hole.
+         */
+        template<class Key, size_t Width>
+        void sift_up(size_t hole) ;
+        /*!
+         * \brief Sifts down the value record from a hole.
+         * \param hole the index of the hole.
+         */
+        template<class Key, size_t Width>
+        void sift_down(size_t hole) ;
+        /*!
+         * \brief Moves a hole up to the top.
+         * \param hole the index of the hole.
+         */
+        template<size_t Width>
+        void raise_hole(size_t hole) ;
+
+        // fields
+        /*!
+         * \brief The maximum number of records of the heap.
+         */
+        size_t _sizeMax ;
+        /*!
+         * \brief The current number of records of the heap.
+         */
+        size_t _size ;
+        /*!
+         * \brief The size of the records.
+         */
+        size_t _record_size ;
+        /*!
+         * \brief The offset of the key in the records.
+         */
+        size_t _key_offset ;
+        /*!
+         * \brief The type of the keys.
+         */
+        record_key _key_type ;
+        /*!
+         * \brief The buffer storing the records.
+         */
+        std::vector<unsigned char> _heap ;
+        /*!
+         * \brief The record being sifted.
+         */
+        std::vector<unsigned char> _value ;
+} ;
+
+
+inline record_heap::record_heap(size_t sizeMax, size_t record_size, size_t key_offset, record_key key_type)
+    : _sizeMax(sizeMax), _size(0), _record_size(record_size), _key_offset(key_offset), _key_type(key_type),
+      _heap(sizeMax * record_size), _value(record_size)
+{	size_t key_size = 0 ;
+    this->dispatch([&key_size](auto key, auto)
+    {	key_size = sizeof(typename decltype(key)::type) ; }) ;
+    if((key_offset > record_size) or (record_size - key_offset < key_size))
+    {	throw std::runtime_error("record_heap key does not fit in the records!") ; }
+}
+
+
+inline const void* record_heap::top() const
+{	return this->record(0) ; }
+
+inline void record_heap::extract_top(void* record)
+{	std::memcpy(record, this->record(0), this->_record_size) ;
+    this->_size-- ;
+    if(this->size() > 0)
+    {	std::memcpy(this->_value.data(), this->record(this->size()), this->_record_size) ;
+        this->dispatch([this](auto key, auto width)
+        {	this->sift_down<typename decltype(key)::type, decltype(width)::value>(0) ; }) ;
+    }
+}
+
+
+inline void record_heap::insert(const void* record)
+{	if(this->full())
+    {	throw std::runtime_error("record_heap is full!") ; }
+
+    std::memcpy(this->_value.data(), record, this->_record_size) ;
+    size_t hole = this->size() ;
+    this->_size++ ;
+    this->dispatch([this, hole](auto key, auto width)
+    {	this->sift_up<typename decltype(key)::type, decltype(width)::value>(hole) ; }) ;
+}
+
+inline void record_heap::remove(int index)
+{	this->_size-- ;
+    this->dispatch([this, index](auto key, auto width)
+    {	// move the hole to the top, as if the record had the
+        // maximum priority, and fill it with the last record
+        this->raise_hole<decltype(width)::value>(index) ;
+        if(this->size() > 0)
+        {	std::memcpy(this->_value.data(), this->record(this->size()), this->_record_size) ;
+            this->sift_down<typename decltype(key)::type, decltype(width)::value>(0) ;
+        }
+    }) ;
+}
+
+
+inline void record_heap::change_priority(int index, const void* record)
+{	std::memcpy(this->_value.data(), record, this->_record_size) ;
+    this->dispatch([this, index](auto key, auto width)
+    {	typedef typename decltype(key)::type key_type ;
+        if(this->load_key<key_type>(this->record(index)) < this->load_key<key_type>(this->_value.data())) // change < to > for min heap
+        {	this->sift_up<key_type, decltype(width)::value>(index) ; }
+        else
+        {	this->sift_down<key_type, decltype(width)::value>(index) ; }
+    }) ;
+}
+
+
+inline int record_heap::find(const void* record) const
+{	for(size_t i=0; i<this->size(); i++)
+    {	if(std::memcmp(this->record(i), record, this->_record_size) == 0)
+        {	return i ; }
+    }
+    return -1 ;
+}
+
+
+inline bool record_heap::empty() const
+{	return this->size() == 0 ; }
+
+inline bool record_heap::full() const
+{	return this->size() == this->_sizeMax ; }
+
+inline size_t record_heap::size() const
+{	return this->_size ; }
+
+inline size_t record_heap::record_size() const
+{	return this->_record_size ; }
+
+inline size_t record_heap::key_offset() const
+{	return this->_key_offset ; }
+
+inline record_key record_heap::key_type() const
+{	return this->_key_type ; }
+
+
+template<class F>
+void record_heap::dispatch(F f) const
+{	switch(this->_key_type)
+    {	case record_key::int32 : this->dispatch_width<std::int32_t>(f) ; break ;
+        case record_key::uint32 : this->dispatch_width<std::uint32_t>(f) ; break ;
+        case record_key::int64 : this->dispatch_width<std::int64_t>(f) ; break ;
+        case record_key::uint64 : this->dispatch_width<std::uint64_t>(f) ; break ;
+        case record_key::float32 : this->dispatch_width<float>(f) ; break ;
+        case record_key::float64 : this->dispatch_width<double>(f) ; break ;
+    }
+}
+
+template<class Key, class F>
+void record_heap::dispatch_width(F f) const
+{	switch(this->_record_size)
+    {	case 8 : f(key_tag<Key>(), std::integral_constant<size_t, 8>()) ; break ;
+        case 16 : f(key_tag<Key>(), std::integral_constant<size_t, 16>()) ; break ;
+        case 32 : f(key_tag<Key>(), std::integral_constant<size_t, 32>()) ; break ;
+        case 64 : f(key_tag<Key>(), std::integral_constant<size_t, 64>()) ; break ;
+        default : f(key_tag<Key>(), std::integral_constant<size_t, 0>()) ; break ;
+    }
+}
+
+
+template<class Key>
+auto record_heap::load_key(const unsigned char* record) const
+{	Key key ;
+    std::memcpy(&key, record + this->_key_offset, sizeof(Key)) ;
+    if constexpr(std::is_floating_point<Key>::value)
+    {	return key_encoding<Key>::encode(key) ; }
+    else
+    {	return key ; }
+}
+
+template<size_t Width>
+void record_heap::move(unsigned char* destination, const unsigned char* source) const
+{	// a constant size lets the compiler emit a few wide moves
+    std::memcpy(destination, source, Width != 0 ? Width : this->_record_size) ;
+}
+
+inline unsigned char* record_heap::record(size_t index)
+{	return this->_heap.data() + index * this->_record_size ; }
+
+inline const unsigned char* record_heap::record(size_t index) const
+{	return this->_heap.data() + index * this->_record_size ; }
+
+
+template<class Key, size_t Width>
+void record_heap::sift_up(size_t hole)
+{	const unsigned char* value = this->_value.data() ;
+    auto key = this->load_key<Key>(value) ;
+    while(hole > 0)
+    {	size_t parent = (hole - 1) / 2 ;
+        if(not (this->load_key<Key>(this->record(parent)) < key)) // change < to > for min heap
+        {	break ; }
+        this->move<Width>(this->record(hole), this->record(parent)) ;
+        hole = parent ;
+    }
+    this->move<Width>(this->record(hole), value) ;
+}
+
+template<class Key, size_t Width>
+void record_heap::sift_down(size_t hole)
+{	const unsigned char* value = this->_value.data() ;
+    auto key = this->load_key<Key>(value) ;
+    size_t len = this->size() ;
+    while(2*hole + 1 < len)
+    {	size_t child = 2*hole + 1 ;
+        auto child_key = this->load_key<Key>(this->record(child)) ;
+        if(child + 1 < len)
+        {	auto right_key = this->load_key<Key>(this->record(child + 1)) ;
+            if(child_key < right_key) // change < to > for min heap
+            {	child++ ;
+                child_key = right_key ;
+            }
+        }
+        if(not (key < child_key)) // change < to > for min heap
+        {	break ; }
+        this->move<Width>(this->record(hole), this->record(child)) ;
+        hole = child ;
+    }
+    this->move<Width>(this->record(hole), value) ;
+}
+
+template<size_t Width>
+void record_heap::raise_hole(size_t hole)
+{	while(hole > 0)
+    {	size_t parent = (hole - 1) / 2 ;
+        this->move<Width>(this->record(hole), this->record(parent)) ;
+        hole = parent ;
+    }
+}
+
+
+inline std::ostream& operator << (std::ostream& stream, const record_heap& h)
+{	h.dispatch([&stream, &h](auto key, auto)
+    {	typedef typename decltype(key)::type key_type ;
+        for(size_t i=0; i<h.size(); i++)
+        {	key_type k ;
+            std::memcpy(&k, h.record(i) + h._key_offset, sizeof(key_type)) ;
+            stream << k << ' ' ;
+        }
+    }) ;
+    return stream ;
+}
+
+#endif // RECORD_HEAP_HPP
@@ -0,0 +1,350 @@
+#ifndef SMALL_BINARY_HEAP_HPP
+#define SMALL_BINARY_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <memory>    // allocator
+#include <algorithm> // swap
+#include <utility>   // move
+#include <stdexcept>
+#include <limits>
+
+
+/*!
+ * \brief The small_binary_heap class implements a maximum binary heap which
+ * first N elements are stored inline, within the object. The elements are
+ * moved to a storage obtained from the allocator only when the heap grows
+ * beyond N elements, such that a heap which never holds more than N elements
+ * never allocates. Once moved, the elements stay in the allocated storage.
+ * It provides the same interface as binary_heap.
+ */
+template<class T, size_t N, class Allocator = std::allocator<T>>
+class small_binary_heap
+{
+    static_assert(N > 0, "small_binary_heap inline capacity must be positive") ;
+
+    public:
+        /*!
+         * \brief Constructs an empty binary heap with a given
+         * maximum size.
+         * \param sizeMax the maximum size of the heap, unbounded
+         * by default.
+         * \param allocator the allocator used when the heap outgrows
+         * its inline storage.
+         */
+        small_binary_heap(size_t sizeMax = std::numeric_limits<size_t>::max(),
+                          const Allocator& allocator = Allocator()) ;
+        /*!
+         * \brief Constructs a binary heap from a given vector.
+         * The maximum size is set to the vector size.
+         * \param v a vector to construct the binary heap from.
+         * \param allocator the allocator used when the vector does not
+         * fit in the inline storage.
+         */
+        small_binary_heap(const std::vector<T>& v, const Allocator& allocator = Allocator()) ;
+
+        // methods
+        /*!
+         * \brief Returns the maximum value of the heap.
+         * \return the maximum value.
+         */
+        T top() const ;
+        /*!
+         * \brief Removes and return the maximum value of the
+         * heap.
+         * \return the maximum value.
+         */
+        T extract_top() ;
+
+        /*!
+         * \brief Insert a given value within the heap. Moves
+         * the elements to the allocated storage if the inline
+         * storage is full.
+         * \param value a value to insert.
+         * \throw std::runtime_error if the heap is full.
+         */
+        void insert(T value) ;
+        /*!
+         * \brief Removes the value at the given index.
+         * \param index the index of the value to remove.
+         */
+        void remove(int index) ;
+        /*!
+         * \brief Changes the priority of the value located
+         * at the given index with the given value.
+         * \param index the index of the priority value to change.
+         * \param priority the new priority value.
+         */
+        void change_priority(int index, T priority) ;
+
+        /*!
+         * \brief Searches the heap for the given value and returns
+         * its index. If it could not be found, -1 is returned. This
+         * method is not time efficient (O(n)).
+         * \param value a value to find in the heap.
+         * \return the index of the value if it has been found,
+         * -1 otherwise.
+         */
+        int find(T value) const ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+        /*!
+         * \brief Checks whether the elements are still stored
+         * inline, that is whether the heap never allocated.
+         * \return whether the elements are stored inline.
+         */
+        bool inlined() const ;
+        /*!
+         * \brief Returns a copy of the allocator used by the heap.
+         * \return the allocator.
+         */
+        Allocator get_allocator() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * a binary heap to a stream.
+         * \param stream an output stream of interest.
+         * \param h a binary heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U, size_t M, class A>
+        friend std::ostream& operator << (std::ostream& stream, const small_binary_heap<U,M,A>& h) ;
+
+    private:
+        // methods
+        /*!
+         * \brief Sifts up the element located at a given index.
+         * \param index the index of the element to sift up.
+         */
+        void sift_up(size_t index) ;
+        /*!
+         * \brief Sifts down the element located at a given index.
+         * \param index the index of the element to sift down.
+         */
+        void sift_down(size_t index) ;
+
+        /*!
+         * \brief Moves the elements from the inline storage
+         * to the allocated storage.
+         */
+        void spill() ;
+
+        /*!
+         * \brief Returns the storage currently in use.
+         * \return a pointer to the first element.
+         */
+        T* data() ;
+        /*!
+         * \brief Returns the storage currently in use.
+         * \return a pointer to the first element.
+         */
+        const T* data() const ;
+
+        // fields
+        /*!
+         * \brief The maximum size of the heap.
+         */
+        size_t _sizeMax ;
+        /*!
+         * \brief The current size of the heap.
+         */
+        size_t _size ;
+        /*!
+         * \brief Whether the elements have been moved to
+         * the allocated storage.
+         */
+        bool _spilled ;
+        /*!
+         * \brief The inline storage.
+         */
+        std::array<T, N> _inline ;
+        /*!
+         * \brief The allocated storage, empty until the
+         * heap outgrows the inline storage.
+         */
+        std::vector<T, Allocator> _heap ;
+} ;
+
+
+template<class T, size_t N, class Allocator>
+small_binary_heap<T,N,Allocator>::small_binary_heap(size_t sizeMax, const Allocator& allocator)
+    : _sizeMax(sizeMax), _size(0), _spilled(false), _inline{}, _heap(allocator)
+{}
+
+template<class T, size_t N, class Allocator>
+small_binary_heap<T,N,Allocator>::small_binary_heap(const std::vector<T>& v, const Allocator& allocator)
+    : _sizeMax(v.size()), _size(v.size()), _spilled(v.size() > N), _inline{}, _heap(allocator)
+{	if(this->_spilled)
+    {	this->_heap.assign(v.begin(), v.end()) ; }
+    else
+    {	std::copy(v.begin(), v.end(), this->_inline.begin()) ; }
+    // enforce binary heap for all non-leaf nodes
+    for(size_t i=this->size()/2; i>0; i--)
+    {	this->sift_down(i-1) ; }
+}
+
+
+template<class T, size_t N, class Allocator>
+T small_binary_heap<T,N,Allocator>::top() const
+{	return this->data()[0] ; }
+
+template<class T, size_t N, class Allocator>
+T small_binary_heap<T,N,Allocator>::extract_top()
+{	T* heap = this->data() ;
+    T top = std::move(heap[0]) ;
+    heap[0] = std::move(heap[this->size()-1]) ;
+    this->_size-- ;
+    if(this->_spilled)
+    {	this->_heap.pop_back() ; }
+    this->sift_down(0) ;
+    return top ;
+}
+
+
+template<class T, size_t N, class Allocator>
+void small_binary_heap<T,N,Allocator>::insert(T value)
+{	if(this->full())
+    {	throw std::runtime_error("small_binary_heap is full!") ; }
+
+    if(this->_spilled)
+    {	this->_heap.push_back(std::move(value)) ; }
+    else if(this->size() < N)
+    {	this->_inline[this->size()] = std::move(value) ; }
+    else
+    {	this->spill() ;
+        this->_heap.push_back(std::move(value)) ;
+    }
+    this->_size++ ;
+    this->sift_up(this->size()-1) ;
+}
+
+template<class T, size_t N, class Allocator>
+void small_binary_heap<T,N,Allocator>::remove(int index)
+{	// move the value to the top, as if it had the maximum priority
+    T* heap = this->data() ;
+    size_t i = index ;
+    while(i > 0)
+    {	std::swap(heap[i], heap[(i-1) / 2]) ;
+        i = (i-1) / 2 ;
+    }
+    this->extract_top() ;
+}
+
+
+template<class T, size_t N, class Allocator>
+void small_binary_heap<T,N,Allocator>::change_priority(int index, T priority)
+{	T* heap = this->data() ;
+    bool increase = priority > heap[index] ;
+    heap[index] = std::move(priority) ;
+    if(increase)
+    {	this->sift_up(index) ; }
+    else
+    {	this->sift_down(index) ; }
+}
+
+
+template<class T, size_t N, class Allocator>
+int small_binary_heap<T,N,Allocator>::find(T value) const
+{   const T* heap = this->data() ;
+    for(size_t i=0; i<this->size(); i++)
+    {   if(heap[i] == value)
+        {   return i ; }
+    }
+    return -1 ;
+}
+
+
+template<class T, size_t N, class Allocator>
+bool small_binary_heap<T,N,Allocator>::empty() const
+{	return this->size() == 0 ; }
+
+template<class T, size_t N, class Allocator>
+bool small_binary_heap<T,N,Allocator>::full() const
+{	return this->size() == this->_sizeMax ; }
+
+template<class T, size_t N, class Allocator>
+size_t small_binary_heap<T,N,Allocator>::size() const
+{	return this->_size ; }
+
+template<class T, size_t N, class Allocator>
+bool small_binary_heap<T,N,Allocator>::inlined() const
+{	return not this->_spilled ; }
+
+template<class T, size_t N, class Allocator>
+Allocator small_binary_heap<T,N,Allocator>::get_allocator() const
+{	return this->_heap.get_allocator() ; }
+
+
+template<class T, size_t N, class Allocator>
+void small_binary_heap<T,N,Allocator>::sift_up(size_t index)
+{	T* heap = this->data() ;
+    while((index > 0) and (heap[index] > heap[(index-1) / 2])) // change > to < for min heap
+    {	std::swap(heap[(index-1) / 2], heap[index]) ;
+        index = (index-1) / 2 ;
+    }
+}
+
+template<class T, size_t N, class Allocator>
+void small_binary_heap<T,N,Allocator>::sift_down(size_t index)
+{	T* heap = this->data() ;
+    while(true)
+    {	size_t maxIndex = index ;
+        size_t child_l = (2*index) + 1 ;
+        size_t child_r = (2*index) + 2 ;
+
+        if((child_l < this->size()) and (heap[child_l] > heap[maxIndex])) // change > to < for min heap
+        {	maxIndex = child_l ; }
+        if((child_r < this->size()) and (heap[child_r] > heap[maxIndex])) // change > to < for min heap
+        {	maxIndex = child_r ; }
+        if(index == maxIndex)
+        {	break ; }
+        std::swap(heap[index], heap[maxIndex]) ;
+        index = maxIndex ;
+    }
+}
+
+
+template<class T, size_t N, class Allocator>
+void small_binary_heap<T,N,Allocator>::spill()
+{	this->_heap.reserve(2*N) ;
+    for(size_t i=0; i<this->size(); i++)
+    {	this->_heap.push_back(std::move(this->_inline[i])) ; }
+    this->_spilled = true ;
+}
+
+template<class T, size_t N, class Allocator>
+T* small_binary_heap<T,N,Allocator>::data()
+{	return this->_spilled ? this->_heap.data() : this->_inline.data() ; }
+
+template<class T, size_t N, class Allocator>
+const T* small_binary_heap<T,N,Allocator>::data() const
+{	return this->_spilled ? this->_heap.data() : this->_inline.data() ; }
+
+
+template<class T, size_t N, class Allocator>
+std::ostream& operator << (std::ostream& stream, const small_binary_heap<T,N,Allocator>& h)
+{	const T* heap = h.data() ;
+    for(size_t i=0; i<h.size(); i++)
+    {	stream << heap[i] << ' ' ; }
+    return stream ;
+}
+
+#endif // SMALL_BINARY_HEAP_HPP
@@ -0,0 +1,336 @@
+#ifndef STABLE_BINARY_HEAP_HPP
+#define STABLE_BINARY_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <memory>     // allocator, allocator_traits
+#include <utility>    // move
+#include <type_traits>
+#include <limits>
+#include <stdexcept>
+#include "heap_algorithm.hpp"
+
+
+/*!
+ * \brief The stable_binary_heap class implements a maximum binary heap in
+ * which the values of equal priority come out in their insertion order
+ * (first in, first out), as a fairness policy may require.
+ * Each value is stored along with its insertion number, taken from a Counter
+ * (uint32_t or uint64_t), which is only compared when the values are equal.
+ * When the counter is exhausted, the values are renumbered from 0 in their
+ * insertion order, in O(n) with a radix sort of their numbers. A 32 bits
+ * counter thus saves 4 bytes per value for a renumbering every 4 billion
+ * insertions.
+ * A value which priority is changed keeps its insertion number.
+ */
+template<class T, class Counter = std::uint64_t, class Allocator = std::allocator<T>>
+class stable_binary_heap
+{
+    static_assert(std::is_unsigned<Counter>::value, "the insertion counter must be unsigned") ;
+
+    public:
+        stable_binary_heap() = delete ;
+        /*!
+         * \brief Constructs an empty heap with a given
+         * maximum size.
+         * \param sizeMax the maximum size of the heap, which
+         * must be smaller than the maximum of Counter.
+         * \param allocator the allocator used to allocate the storage.
+         * \throw std::runtime_error if the counter is too small.
+         */
+        stable_binary_heap(size_t sizeMax, const Allocator& allocator = Allocator()) ;
+        /*!
+         * \brief Constructs a heap from a given vector, in O(n),
+         * the values being inserted in their order in the vector.
+         * The maximum size is set to the vector size.
+         * \param v a vector to construct the heap from.
+         * \param allocator the allocator used to allocate the storage.
+         * \throw std::runtime_error if the counter is too small.
+         */
+        stable_binary_heap(const std::vector<T>& v, const Allocator& allocator = Allocator()) ;
+
+        // methods
+        /*!
+         * \brief Returns the maximum value of the heap, the first
+         * inserted among the equal ones.
+         * \return the maximum value.
+         */
+        T top() const ;
+        /*!
+         * \brief Removes and return the maximum value of the
+         * heap, the first inserted among the equal ones.
+         * \return the maximum value.
+         */
+        T extract_top() ;
+
+        /*!
+         * \brief Insert a given value within the heap.
+         * \param value a value to insert.
+         * \throw std::runtime_error if the heap is full.
+         */
+        void insert(T value) ;
+        /*!
+         * \brief Removes the value at the given index.
+         * \param index the index of the value to remove.
+         */
+        void remove(int index) ;
+        /*!
+         * \brief Changes the priority of the value located
+         * at the given index with the given value, which keeps
+         * its insertion number.
+         * \param index the index of the priority value to change.
+         * \param priority the new priority value.
+         */
+        void change_priority(int index, T priority) ;
+
+        /*!
+         * \brief Searches the heap for the given value and returns
+         * its index. If it could not be found, -1 is returned. This
+         * method is not time efficient (O(n)).
+         * \param value a value to find in the heap.
+         * \return the index of the value if it has been found,
+         * -1 otherwise.
+         */
+        int find(T value) const ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+        /*!
+         * \brief Returns the number of times the values have
+         * been renumbered.
+         * \return the number of renumberings.
+         */
+        size_t renumberings() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * a stable binary heap to a stream.
+         * \param stream an output stream of interest.
+         * \param h a stable binary heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U, class C, class A>
+        friend std::ostream& operator << (std::ostream& stream, const stable_binary_heap<U,C,A>& h) ;
+
+    private:
+        /*!
+         * \brief A value along with its insertion number.
+         */
+        struct entry
+        {	T value ;
+            Counter order ;
+        } ;
+
+        /*!
+         * \brief Orders the entries by value, then by decreasing
+         * insertion number, such that the first inserted of the
+         * equal values is the largest entry.
+         */
+        struct compare_type
+        {	bool operator () (const entry& a, const entry& b) const
+            {	if(a.value < b.value) // change < to > for min heap
+                {	return true ; }
+                if(b.value < a.value) // change < to > for min heap
+                {	return false ; }
+                return a.order > b.order ;
+            }
+        } ;
+
+        typedef std::ptrdiff_t index_type ;
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<entry> entry_allocator_type ;
+
+        // methods
+        /*!
+         * \brief Returns the next insertion number, renumbering
+         * the values when the counter is exhausted.
+         * \return the insertion number.
+         */
+        Counter next_order() ;
+        /*!
+         * \brief Renumbers the values from 0 in their insertion
+         * order, in O(n).
+         */
+        void renumber() ;
+
+        // fields
+        /*!
+         * \brief The maximum size of the heap.
+         */
+        size_t _sizeMax ;
+        /*!
+         * \brief The current size of the heap.
+         */
+        size_t _size ;
+        /*!
+         * \brief The next insertion number.
+         */
+        Counter _next ;
+        /*!
+         * \brief The number of renumberings.
+         */
+        size_t _renumberings ;
+        /*!
+         * \brief The vector storing the heap.
+         */
+        std::vector<entry, entry_allocator_type> _heap ;
+} ;
+
+
+template<class T, class Counter, class Allocator>
+stable_binary_heap<T,Counter,Allocator>::stable_binary_heap(size_t sizeMax, const Allocator& allocator)
+    : _sizeMax(sizeMax), _size(0), _next(0), _renumberings(0), _heap(sizeMax, entry_allocator_type(allocator))
+{	if(sizeMax >= std::numeric_limits<Counter>::max())
+    {	throw std::runtime_error("stable_binary_heap counter is too small!") ; }
+}
+
+template<class T, class Counter, class Allocator>
+stable_binary_heap<T,Counter,Allocator>::stable_binary_heap(const std::vector<T>& v, const Allocator& allocator)
+    : _sizeMax(v.size()), _size(v.size()), _next(0), _renumberings(0), _heap(entry_allocator_type(allocator))
+{	if(v.size() >= std::numeric_limits<Counter>::max())
+    {	throw std::runtime_error("stable_binary_heap counter is too small!") ; }
+    this->_heap.reserve(v.size()) ;
+    for(const T& value : v)
+    {	this->_heap.push_back(entry{value, this->_next++}) ; }
+    heap_make(this->_heap.begin(), this->_heap.end(), compare_type()) ;
+}
+
+
+template<class T, class Counter, class Allocator>
+T stable_binary_heap<T,Counter,Allocator>::top() const
+{	return this->_heap[0].value ; }
+
+template<class T, class Counter, class Allocator>
+T stable_binary_heap<T,Counter,Allocator>::extract_top()
+{	T top = std::move(this->_heap[0].value) ;
+    this->_size-- ;
+    if(this->size() > 0)
+    {	heap_sift_down_floyd<2>(this->_heap.begin(), this->size(), 0, std::move(this->_heap[this->size()]), compare_type()) ; }
+    return top ;
+}
+
+
+template<class T, class Counter, class Allocator>
+void stable_binary_heap<T,Counter,Allocator>::insert(T value)
+{	if(this->full())
+    {	throw std::runtime_error("stable_binary_heap is full!") ; }
+
+    Counter order = this->next_order() ;
+    index_type hole = this->size() ;
+    this->_size++ ;
+    heap_sift_up<2>(this->_heap.begin(), 0, hole, entry{std::move(value), order}, compare_type()) ;
+}
+
+template<class T, class Counter, class Allocator>
+void stable_binary_heap<T,Counter,Allocator>::remove(int index)
+{	// move the hole to the top, as if the value had the maximum priority
+    index_type hole = index ;
+    while(hole > 0)
+    {	index_type parent = heap_parent<2>(hole) ;
+        this->_heap[hole] = std::move(this->_heap[parent]) ;
+        hole = parent ;
+    }
+    this->_size-- ;
+    if(this->size() > 0)
+    {	heap_sift_down_floyd<2>(this->_heap.begin(), this->size(), 0, std::move(this->_heap[this->size()]), compare_type()) ; }
+}
+
+
+template<class T, class Counter, class Allocator>
+void stable_binary_heap<T,Counter,Allocator>::change_priority(int index, T priority)
+{	entry changed{std::move(priority), this->_heap[index].order} ;
+    if(compare_type()(this->_heap[index], changed))
+    {	heap_sift_up<2>(this->_heap.begin(), 0, index, std::move(changed), compare_type()) ; }
+    else
+    {	heap_sift_down<2>(this->_heap.begin(), this->size(), index, std::move(changed), compare_type()) ; }
+}
+
+
+template<class T, class Counter, class Allocator>
+int stable_binary_heap<T,Counter,Allocator>::find(T value) const
+{	for(size_t i=0; i<this->size(); i++)
+    {	if(this->_heap[i].value == value)
+        {	return i ; }
+    }
+    return -1 ;
+}
+
+
+template<class T, class Counter, class Allocator>
+bool stable_binary_heap<T,Counter,Allocator>::empty() const
+{	return this->size() == 0 ; }
+
+template<class T, class Counter, class Allocator>
+bool stable_binary_heap<T,Counter,Allocator>::full() const
+{	return this->size() == this->_sizeMax ; }
+
+template<class T, class Counter, class Allocator>
+size_t stable_binary_heap<T,Counter,Allocator>::size() const
+{	return this->_size ; }
+
+template<class T, class Counter, class Allocator>
+size_t stable_binary_heap<T,Counter,Allocator>::renumberings() const
+{	return this->_renumberings ; }
+
+
+template<class T, class Counter, class Allocator>
+Counter stable_binary_heap<T,Counter,Allocator>::next_order()
+{	if(this->_next == std::numeric_limits<Counter>::max())
+    {	this->renumber() ; }
+    return this->_next++ ;
+}
+
+template<class T, class Counter, class Allocator>
+void stable_binary_heap<T,Counter,Allocator>::renumber()
+{	// sort the indices of the values by insertion number, one
+    // byte at a time from the least significant one
+    const size_t n = this->size() ;
+    std::vector<size_t> indices(n), sorted(n) ;
+    for(size_t i=0; i<n; i++)
+    {	indices[i] = i ; }
+    for(size_t shift=0; shift<8*sizeof(Counter); shift+=8)
+    {	std::array<size_t, 257> offsets{} ;
+        for(size_t i=0; i<n; i++)
+        {	offsets[((this->_heap[i].order >> shift) & 0xff) + 1]++ ; }
+        // the byte is the same for all the values, the pass
+        // would not change the order
+        if(offsets[((this->_heap[0].order >> shift) & 0xff) + 1] == n)
+        {	continue ; }
+        for(size_t b=1; b<257; b++)
+        {	offsets[b] += offsets[b-1] ; }
+        for(size_t i : indices)
+        {	sorted[offsets[(this->_heap[i].order >> shift) & 0xff]++] = i ; }
+        indices.swap(sorted) ;
+    }
+    // the relative order of the numbers is kept, as is the heap
+    for(size_t rank=0; rank<n; rank++)
+    {	this->_heap[indices[rank]].order = static_cast<Counter>(rank) ; }
+    this->_next = static_cast<Counter>(n) ;
+    this->_renumberings++ ;
+}
+
+
+template<class T, class Counter, class Allocator>
+std::ostream& operator << (std::ostream& stream, const stable_binary_heap<T,Counter,Allocator>& h)
+{	for(size_t i=0; i<h.size(); i++)
+    {	stream << h._heap[i].value << ' ' ; }
+    return stream ;
+}
+
+#endif // STABLE_BINARY_HEAP_HPP
@@ -0,0 +1,315 @@
+#ifndef STATIC_BINARY_HEAP_HPP
+#define STATIC_BINARY_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <initializer_list>
+#include <utility>   // move
+#include <stdexcept>
+
+
+/*!
+ * \brief The static_binary_heap class implements a maximum binary heap which
+ * elements are stored inline, in an array of fixed capacity N. It never
+ * allocates and provides the same interface as binary_heap.
+ * The sift loops are unrolled at compile time (a heap of capacity N has
+ * at most log2(N) levels) and all the methods are constexpr, such that
+ * the heap can be used in constant expressions (C++17).
+ */
+template<class T, size_t N>
+class static_binary_heap
+{
+    static_assert(N > 0, "static_binary_heap capacity must be positive") ;
+
+    public:
+        /*!
+         * \brief Constructs an empty binary heap, the maximum
+         * size being N.
+         */
+        constexpr static_binary_heap() ;
+        /*!
+         * \brief Constructs a binary heap from the given values.
+         * \param values the values to construct the binary heap from.
+         * \throw std::runtime_error if there are more than N values.
+         */
+        constexpr static_binary_heap(std::initializer_list<T> values) ;
+        /*!
+         * \brief Constructs a binary heap from a given vector.
+         * \param v a vector to construct the binary heap from.
+         * \throw std::runtime_error if the vector has more than N values.
+         */
+        static_binary_heap(const std::vector<T>& v) ;
+
+        // methods
+        /*!
+         * \brief Returns the maximum value of the heap.
+         * \return the maximum value.
+         */
+        constexpr T top() const ;
+        /*!
+         * \brief Removes and return the maximum value of the
+         * heap.
+         * \return the maximum value.
+         */
+        constexpr T extract_top() ;
+
+        /*!
+         * \brief Insert a given value within the heap.
+         * \param value a value to insert.
+         * \throw std::runtime_error if the heap is full.
+         */
+        constexpr void insert(T value) ;
+        /*!
+         * \brief Removes the value at the given index.
+         * \param index the index of the value to remove.
+         */
+        constexpr void remove(int index) ;
+        /*!
+         * \brief Changes the priority of the value located
+         * at the given index with the given value.
+         * \param index the index of the priority value to change.
+         * \param priority the new priority value.
+         */
+        constexpr void change_priority(int index, T priority) ;
+
+        /*!
+         * \brief Searches the heap for the given value and returns
+         * its index. If it could not be found, -1 is returned. This
+         * method is not time efficient (O(n)).
+         * \param value a value to find in the heap.
+         * \return the index of the value if it has been found,
+         * -1 otherwise.
+         */
+        constexpr int find(T value) const ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        constexpr bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to N).
+         * \return whether the heap is full.
+         */
+        constexpr bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap.
+         * \return the size of the heap.
+         */
+        constexpr size_t size() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * a binary heap to a stream.
+         * \param stream an output stream of interest.
+         * \param h a binary heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U, size_t M>
+        friend std::ostream& operator << (std::ostream& stream, const static_binary_heap<U,M>& h) ;
+
+    private:
+        // methods
+        /*!
+         * \brief Sifts up the element located at a given index.
+         * The recursion on Level is resolved at compile time,
+         * which unrolls the loop over the (at most) log2(N)
+         * levels.
+         * \param index the index of the element to sift up.
+         */
+        template<size_t Level = 0>
+        constexpr void sift_up(size_t index) ;
+        /*!
+         * \brief Sifts down the element located at a given index.
+         * The recursion on Level is resolved at compile time,
+         * which unrolls the loop over the (at most) log2(N)
+         * levels.
+         * \param index the index of the element to sift down.
+         */
+        template<size_t Level = 0>
+        constexpr void sift_down(size_t index) ;
+
+        /*!
+         * \brief Swaps the elements located at the given indices.
+         * std::swap is not constexpr before C++20.
+         * \param i the index of the first element.
+         * \param j the index of the second element.
+         */
+        constexpr void swap(size_t i, size_t j) ;
+
+        /*!
+         * \brief Returns the number of levels of a heap of
+         * capacity N, minus one.
+         * \return the depth of the heap.
+         */
+        static constexpr size_t depth() ;
+
+        // fields
+        /*!
+         * \brief The current size of the heap.
+         */
+        size_t _size ;
+        /*!
+         * \brief The array storing the heap.
+         */
+        std::array<T, N> _heap ;
+} ;
+
+
+template<class T, size_t N>
+constexpr static_binary_heap<T,N>::static_binary_heap()
+    : _size(0), _heap{}
+{}
+
+template<class T, size_t N>
+constexpr static_binary_heap<T,N>::static_binary_heap(std::initializer_list<T> values)
+    : _size(0), _heap{}
+{	for(const auto& value : values)
+    {	this->insert(value) ; }
+}
+
+template<class T, size_t N>
+static_binary_heap<T,N>::static_binary_heap(const std::vector<T>& v)
+    : _size(0), _heap{}
+{	if(v.size() > N)
+    {	throw std::runtime_error("static_binary_heap capacity exceeded!") ; }
+
+    for(size_t i=0; i<v.size(); i++)
+    {	this->_heap[i] = v[i] ; }
+    this->_size = v.size() ;
+    // enforce binary heap for all non-leaf nodes
+    for(size_t i=this->size()/2; i>0; i--)
+    {	this->sift_down(i-1) ; }
+}
+
+
+template<class T, size_t N>
+constexpr T static_binary_heap<T,N>::top() const
+{	return this->_heap[0] ; }
+
+template<class T, size_t N>
+constexpr T static_binary_heap<T,N>::extract_top()
+{	T top = this->_heap[0] ;
+    this->_heap[0] = std::move(this->_heap[this->size()-1]) ;
+    this->_size-- ;
+    this->sift_down(0) ;
+    return top ;
+}
+
+
+template<class T, size_t N>
+constexpr void static_binary_heap<T,N>::insert(T value)
+{	if(this->full())
+    {	throw std::runtime_error("static_binary_heap is full!") ; }
+
+    this->_size++ ;
+    this->_heap[this->size()-1] = std::move(value) ;
+    this->sift_up(this->size()-1) ;
+}
+
+template<class T, size_t N>
+constexpr void static_binary_heap<T,N>::remove(int index)
+{	// move the value to the top, as if it had the maximum priority
+    size_t i = index ;
+    while(i > 0)
+    {	this->swap(i, (i-1) / 2) ;
+        i = (i-1) / 2 ;
+    }
+    this->extract_top() ;
+}
+
+
+template<class T, size_t N>
+constexpr void static_binary_heap<T,N>::change_priority(int index, T priority)
+{	bool increase = priority > this->_heap[index] ;
+    this->_heap[index] = std::move(priority) ;
+    if(increase)
+    {	this->sift_up(index) ; }
+    else
+    {	this->sift_down(index) ; }
+}
+
+
+template<class T, size_t N>
+constexpr int static_binary_heap<T,N>::find(T value) const
+{   for(size_t i=0; i<this->size(); i++)
+    {   if(this->_heap[i] == value)
+        {   return i ; }
+    }
+    return -1 ;
+}
+
+
+template<class T, size_t N>
+constexpr bool static_binary_heap<T,N>::empty() const
+{	return this->size() == 0 ; }
+
+template<class T, size_t N>
+constexpr bool static_binary_heap<T,N>::full() const
+{	return this->size() == N ; }
+
+template<class T, size_t N>
+constexpr size_t static_binary_heap<T,N>::size() const
+{	return this->_size ; }
+
+
+template<class T, size_t N>
+template<size_t Level>
+constexpr void static_binary_heap<T,N>::sift_up(size_t index)
+{	if constexpr(Level < depth())
+    {	size_t parent = (index-1) / 2 ;
+        if((index > 0) and (this->_heap[index] > this->_heap[parent])) // change > to < for min heap
+        {	this->swap(parent, index) ;
+            this->sift_up<Level+1>(parent) ;
+        }
+    }
+}
+
+template<class T, size_t N>
+template<size_t Level>
+constexpr void static_binary_heap<T,N>::sift_down(size_t index)
+{	if constexpr(Level < depth())
+    {	size_t maxIndex = index ;
+        size_t child_l = (2*index) + 1 ;
+        size_t child_r = (2*index) + 2 ;
+
+        if((child_l < this->size()) and (this->_heap[child_l] > this->_heap[maxIndex])) // change > to < for min heap
+        {	maxIndex = child_l ; }
+        if((child_r < this->size()) and (this->_heap[child_r] > this->_heap[maxIndex])) // change > to < for min heap
+        {	maxIndex = child_r ; }
+        if(index != maxIndex)
+        {	this->swap(index, maxIndex) ;
+            this->sift_down<Level+1>(maxIndex) ;
+        }
+    }
+}
+
+
+template<class T, size_t N>
+constexpr void static_binary_heap<T,N>::swap(size_t i, size_t j)
+{	T tmp = std::move(this->_heap[i]) ;
+    this->_heap[i] = std::move(this->_heap[j]) ;
+    this->_heap[j] = std::move(tmp) ;
+}
+
+template<class T, size_t N>
+constexpr size_t static_binary_heap<T,N>::depth()
+{	size_t depth = 0 ;
+    for(size_t n=N; n>1; n/=2)
+    {	depth++ ; }
+    return depth ;
+}
+
+
+template<class T, size_t N>
+std::ostream& operator << (std::ostream& stream, const static_binary_heap<T,N>& h)
+{	for(size_t i=0; i<h.size(); i++)
+    {	stream << h._heap[i] << ' ' ; }
+    return stream ;
+}
+
+#endif // STATIC_BINARY_HEAP_HPP
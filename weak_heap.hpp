@@ -0,0 +1,327 @@
+#ifndef WEAK_HEAP_HPP
+#define WEAK_HEAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <memory>    // allocator, allocator_traits
+#include <algorithm> // swap
+#include <utility>   // move
+#include <stdexcept>
+
+
+/*!
+ * \brief The weak_heap class implements a maximum weak heap (Dutton, 1993),
+ * with the same interface as binary_heap. It is meant for elements which
+ * comparisons are expensive : building a heap costs n-1 comparisons and an
+ * extraction at most ceil(log2(n)) comparisons, where binary_heap needs up to
+ * 2 log2(n) comparisons.
+ * A weak heap relaxes the heap order : each element is only greater than or
+ * equal to the elements of its right subtree, the root having no left subtree.
+ * The elements are stored in an array with one reverse bit per element, which
+ * swaps the children of the element : the left child of the element at index
+ * i is at index 2i+r[i] and its right child at index 2i+1-r[i].
+ */
+template<class T, class Allocator = std::allocator<T>>
+class weak_heap
+{
+    public:
+        weak_heap() = delete ;
+        /*!
+         * \brief Constructs an empty weak heap with a given
+         * maximum size.
+         * \param sizeMax the maximum size of the heap.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        weak_heap(size_t sizeMax, const Allocator& allocator = Allocator()) ;
+        /*!
+         * \brief Constructs a weak heap from a given vector, using
+         * n-1 comparisons. The maximum size is set to the vector size.
+         * \param v a vector to construct the weak heap from.
+         * \param allocator the allocator used to allocate the storage.
+         */
+        weak_heap(const std::vector<T>& v, const Allocator& allocator = Allocator()) ;
+
+        // methods
+        /*!
+         * \brief Returns the maximum value of the heap.
+         * \return the maximum value.
+         */
+        T top() const ;
+        /*!
+         * \brief Removes and return the maximum value of the
+         * heap.
+         * \return the maximum value.
+         */
+        T extract_top() ;
+
+        /*!
+         * \brief Insert a given value within the heap.
+         * \param value a value to insert.
+         * \throw std::runtime_error if the heap is full.
+         */
+        void insert(T value) ;
+        /*!
+         * \brief Removes the value at the given index.
+         * \param index the index of the value to remove.
+         */
+        void remove(int index) ;
+        /*!
+         * \brief Changes the priority of the value located
+         * at the given index with the given value. Decreasing
+         * a priority removes the value and inserts it again.
+         * \param index the index of the priority value to change.
+         * \param priority the new priority value.
+         */
+        void change_priority(int index, T priority) ;
+
+        /*!
+         * \brief Searches the heap for the given value and returns
+         * its index. If it could not be found, -1 is returned. This
+         * method is not time efficient (O(n)).
+         * \param value a value to find in the heap.
+         * \return the index of the value if it has been found,
+         * -1 otherwise.
+         */
+        int find(T value) const ;
+
+        /*!
+         * \brief Checks whether the heap is empty.
+         * \return whether the heap is empty.
+         */
+        bool empty() const ;
+        /*!
+         * \brief Checks whether the heap is full (its
+         * size is equal to the maximum size).
+         * \return whether the heap is full.
+         */
+        bool full() const ;
+        /*!
+         * \brief Returns the current size of the heap.
+         * \return the size of the heap.
+         */
+        size_t size() const ;
+
+    public:
+        // friendly functions
+        /*!
+         * \brief Overload the << operator to send a string representation of
+         * a weak heap to a stream.
+         * \param stream an output stream of interest.
+         * \param h a weak heap of interest.
+         * \return a reference to the stream.
+         */
+        template<class U, class A>
+        friend std::ostream& operator << (std::ostream& stream, const weak_heap<U,A>& h) ;
+
+    private:
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<unsigned char> bit_allocator ;
+
+        // methods
+        /*!
+         * \brief Sifts up the element located at a given index,
+         * through its distinguished ancestors.
+         * \param index the index of the element to sift up.
+         */
+        void sift_up(size_t index) ;
+        /*!
+         * \brief Sifts down the root, by joining it with all the
+         * elements of the path of left children from its right
+         * child, bottom-up.
+         */
+        void sift_down() ;
+        /*!
+         * \brief Joins the element at a given index with its
+         * distinguished ancestor : if it is greater than its
+         * ancestor, they are swapped and the subtrees of the
+         * element are swapped as well.
+         * \param i the index of the distinguished ancestor.
+         * \param j the index of the element.
+         * \return whether the element and its ancestor were
+         * in order (not swapped).
+         */
+        bool join(size_t i, size_t j) ;
+
+        /*!
+         * \brief Returns the index of the distinguished ancestor of
+         * the element located at the given index, that is the parent
+         * of the first ancestor (or the element itself) which is a
+         * right child. The element belongs to the right subtree of its
+         * distinguished ancestor, and thus must not be greater.
+         * \param index the index of the element of interest.
+         * \return the index of the distinguished ancestor.
+         */
+        size_t distinguished_ancestor(size_t index) const ;
+
+        // fields
+        /*!
+         * \brief The maximum size of the heap.
+         */
+        size_t _sizeMax ;
+        /*!
+         * \brief The current size of the heap.
+         */
+        size_t _size ;
+        /*!
+         * \brief The vector storing the heap.
+         */
+        std::vector<T, Allocator> _heap ;
+        /*!
+         * \brief The reverse bits.
+         */
+        std::vector<unsigned char, bit_allocator> _reverse ;
+} ;
+
+
+template<class T, class Allocator>
+weak_heap<T,Allocator>::weak_heap(size_t sizeMax, const Allocator& allocator)
+    : _sizeMax(sizeMax), _size(0), _heap(sizeMax, allocator),
+      _reverse(sizeMax, 0, bit_allocator(allocator))
+{}
+
+template<class T, class Allocator>
+weak_heap<T,Allocator>::weak_heap(const std::vector<T>& v, const Allocator& allocator)
+    : _sizeMax(v.size()), _size(v.size()), _heap(v.begin(), v.end(), allocator),
+      _reverse(v.size(), 0, bit_allocator(allocator))
+{	// join every element with its distinguished ancestor, bottom-up
+    for(size_t j=this->size(); j>1; j--)
+    {	this->join(this->distinguished_ancestor(j-1), j-1) ; }
+}
+
+
+template<class T, class Allocator>
+T weak_heap<T,Allocator>::top() const
+{	return this->_heap[0] ; }
+
+template<class T, class Allocator>
+T weak_heap<T,Allocator>::extract_top()
+{	T top = this->_heap[0] ;
+    this->_size-- ;
+    if(this->size() > 0)
+    {	this->_heap[0] = std::move(this->_heap[this->size()]) ;
+        this->sift_down() ;
+    }
+    return top ;
+}
+
+
+template<class T, class Allocator>
+void weak_heap<T,Allocator>::insert(T value)
+{	if(this->full())
+    {	throw std::runtime_error("weak_heap is full!") ; }
+
+    size_t j = this->size() ;
+    this->_size++ ;
+    this->_heap[j] = std::move(value) ;
+    this->_reverse[j] = 0 ;
+    // a new first child is the left child of its parent, its parent
+    // having had no subtree so far
+    if((j % 2 == 0) and (j > 0))
+    {	this->_reverse[j/2] = 0 ; }
+    this->sift_up(j) ;
+}
+
+template<class T, class Allocator>
+void weak_heap<T,Allocator>::remove(int index)
+{	// move the value to the top, as if it had the maximum priority
+    size_t j = index ;
+    while(j != 0)
+    {	size_t i = this->distinguished_ancestor(j) ;
+        std::swap(this->_heap[i], this->_heap[j]) ;
+        this->_reverse[j] ^= 1 ;
+        j = i ;
+    }
+    this->extract_top() ;
+}
+
+
+template<class T, class Allocator>
+void weak_heap<T,Allocator>::change_priority(int index, T priority)
+{	if(priority > this->_heap[index])
+    {	this->_heap[index] = std::move(priority) ;
+        this->sift_up(index) ;
+    }
+    else
+    {	// the subtrees of the ancestors of the value may not
+        // be dominated anymore
+        this->remove(index) ;
+        this->insert(std::move(priority)) ;
+    }
+}
+
+
+template<class T, class Allocator>
+int weak_heap<T,Allocator>::find(T value) const
+{   for(size_t i=0; i<this->size(); i++)
+    {   if(this->_heap[i] == value)
+        {   return i ; }
+    }
+    return -1 ;
+}
+
+
+template<class T, class Allocator>
+bool weak_heap<T,Allocator>::empty() const
+{	return this->size() == 0 ; }
+
+template<class T, class Allocator>
+bool weak_heap<T,Allocator>::full() const
+{	return this->size() == this->_sizeMax ; }
+
+template<class T, class Allocator>
+size_t weak_heap<T,Allocator>::size() const
+{	return this->_size ; }
+
+
+template<class T, class Allocator>
+void weak_heap<T,Allocator>::sift_up(size_t index)
+{	while(index != 0)
+    {	size_t i = this->distinguished_ancestor(index) ;
+        if(this->join(i, index))
+        {	break ; }
+        index = i ;
+    }
+}
+
+template<class T, class Allocator>
+void weak_heap<T,Allocator>::sift_down()
+{	if(this->size() < 2)
+    {	return ; }
+    // the last element of the path of left children from the right child of the root
+    size_t j = 1 ;
+    while((2*j) + this->_reverse[j] < this->size())
+    {	j = (2*j) + this->_reverse[j] ; }
+    // join the root with all the elements of the path, bottom-up
+    while(j != 0)
+    {	this->join(0, j) ;
+        j /= 2 ;
+    }
+}
+
+template<class T, class Allocator>
+bool weak_heap<T,Allocator>::join(size_t i, size_t j)
+{	if(this->_heap[j] > this->_heap[i]) // change > to < for min heap
+    {	std::swap(this->_heap[i], this->_heap[j]) ;
+        this->_reverse[j] ^= 1 ;
+        return false ;
+    }
+    return true ;
+}
+
+
+template<class T, class Allocator>
+size_t weak_heap<T,Allocator>::distinguished_ancestor(size_t index) const
+{	// climb while the element is a left child
+    while((index % 2) == this->_reverse[index / 2])
+    {	index /= 2 ; }
+    return index / 2 ;
+}
+
+
+template<class T, class Allocator>
+std::ostream& operator << (std::ostream& stream, const weak_heap<T,Allocator>& h)
+{	for(size_t i=0; i<h.size(); i++)
+    {	stream << h._heap[i] << ' ' ; }
+    return stream ;
+}
+
+#endif // WEAK_HEAP_HPP